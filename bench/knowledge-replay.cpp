@@ -0,0 +1,86 @@
+// Replays recorded frames through TickDelta and KnowledgeMap and prints one
+// digest line per GameState, to compare KnowledgeMap::update across revisions.
+// Usage: knowledge-replay <frames.jsonl>
+// The input holds one received frame per line, like for packet-parser-bench.
+// Every LobbyData frame starts a new match. Build the tool at both revisions,
+// run it on the same recording and diff the outputs: a line differs exactly
+// when the remembered objects, their stamps, the known and hazards planes,
+// the remembered mines or the danger map differ after that tick.
+
+#include "pch.h"
+#include "frame-classifier.h"
+#include "nlohmann-packet-parser.h"
+#include "bot/utils.h"
+#include <fstream>
+
+namespace {
+
+/// FNV-1a over the values fed to it
+struct Digest {
+	uint64_t hash = 1469598103934665603ull;
+
+	void Add(uint64_t value) {
+		hash = (hash ^ value) * 1099511628211ull;
+	}
+};
+
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <frames.jsonl>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream input(argv[1]);
+	NlohmannPacketParser parser;
+	KnowledgeMap knowledgeMap;
+	TickDelta delta;
+	int dim = 0;
+	int match = 0;
+	for (std::string line; std::getline(input, line);) {
+		auto type = PeekPacketType(line);
+		if (type == PacketType::LobbyData) {
+			dim = parser.ParseLobbyData(line).gridDimension;
+			knowledgeMap.init(dim);
+			delta.init(dim);
+			++match;
+		}
+		if (type != PacketType::GameState || dim == 0) continue;
+
+		GameState gameState;
+		std::string id;
+		parser.ParseGameState(line, gameState, id);
+		delta.update(gameState.map.grid);
+		knowledgeMap.update(gameState, delta);
+
+		Digest digest;
+		size_t objects = 0;
+		size_t mines = 0;
+		for (int x = 0; x < dim; ++x) {
+			for (int y = 0; y < dim; ++y) {
+				// Order inside a tile is not part of the knowledge
+				std::vector<std::pair<int, size_t>> stamps;
+				for (const auto& known : knowledgeMap.tile(x, y)) {
+					stamps.emplace_back(known.lastSeen, known.object.index());
+				}
+				std::sort(stamps.begin(), stamps.end());
+				for (const auto& [lastSeen, index] : stamps) {
+					digest.Add(static_cast<uint64_t>(x) << 32 | y);
+					digest.Add(lastSeen);
+					digest.Add(index);
+				}
+				objects += stamps.size();
+				bool mine = knowledgeMap.containsMine(Position(x, y));
+				mines += mine;
+				digest.Add(mine);
+				digest.Add(knowledgeMap.known.Test(x, y));
+				digest.Add(knowledgeMap.hazards.Test(x, y));
+				digest.Add(knowledgeMap.danger.earliest(x, y));
+			}
+		}
+		std::cout << match << " " << gameState.time << " " << objects << " " << mines << " " << std::hex << digest.hash
+				  << std::dec << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,163 @@
+// Compares the JSON backends on recorded GameState frames.
+// Usage: packet-parser-bench <frames.jsonl> [iterations]
+// The input holds one received frame per line. The first LobbyData frame starts
+// the match like it does for the bot, so large grids are decoded in parallel;
+// other frames besides GameState are ignored. Each backend's GameStateView is
+// also checked against its full decode of every frame.
+
+#include "pch.h"
+#include "frame-classifier.h"
+#include "nlohmann-packet-parser.h"
+#include "simdjson-packet-parser.h"
+#include <fstream>
+#include <numeric>
+
+namespace {
+
+struct Result {
+	double meanMicros;
+	double medianMicros;
+	double megabytesPerSecond;
+	/// Tile objects decoded in one pass over all frames, compared across backends
+	size_t objects;
+};
+
+template<class Parser>
+Result Run(const std::string& lobby, const std::vector<std::string>& frames, size_t totalBytes, int iterations) {
+	Parser parser;
+	if (!lobby.empty()) parser.ParseLobbyData(lobby);
+	std::vector<double> samples;
+	samples.reserve(frames.size() * iterations);
+	size_t objects = 0;
+
+	for (int iteration = 0; iteration <= iterations; ++iteration) {
+		for (const auto& frame : frames) {
+			GameState gameState;
+			std::string id;
+			auto start = std::chrono::steady_clock::now();
+			parser.ParseGameState(frame, gameState, id);
+			auto end = std::chrono::steady_clock::now();
+
+			// First pass only warms up caches and the parser's buffers
+			if (iteration == 0) {
+				const Grid& grid = gameState.map.grid;
+				objects += grid.tanks.size() + grid.bullets.size() + grid.lasers.size() + grid.mines.size() + grid.items.size();
+				continue;
+			}
+			samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+		}
+	}
+
+	double total = std::accumulate(samples.begin(), samples.end(), 0.0);
+	std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+	return Result{
+		total / samples.size(),
+		samples[samples.size() / 2],
+		static_cast<double>(totalBytes) * iterations / total,
+		objects
+	};
+}
+
+template<class T>
+bool SameObject(GameStateView& view, const Grid& grid, int x, int y) {
+	const T* lazy = view.Find<T>(x, y);
+	const T* full = grid.Find<T>(x, y);
+	return lazy == nullptr ? full == nullptr : full != nullptr && *lazy == *full;
+}
+
+/// Number of frames on which GameStateView disagrees with the full decode
+template<class Parser>
+size_t CheckView(const std::string& lobby, const std::vector<std::string>& frames) {
+	Parser parser;
+	if (!lobby.empty()) parser.ParseLobbyData(lobby);
+	size_t mismatches = 0;
+
+	for (const auto& frame : frames) {
+		GameState gameState;
+		std::string id;
+		parser.ParseGameState(frame, gameState, id);
+		const Grid& grid = gameState.map.grid;
+		GameStateView& view = parser.ViewGameState(frame);
+
+		bool same = view.Id() == id && view.Time() == gameState.time && view.Dim() == grid.dim;
+		const auto& players = view.Players();
+		same = same && players.size() == gameState.players.size();
+		for (size_t i = 0; same && i < players.size(); ++i) {
+			same = players[i].id == gameState.players[i].id && players[i].ticksToRegen == gameState.players[i].ticksToRegen;
+		}
+		const auto& zones = view.Zones();
+		same = same && zones.size() == gameState.map.zones.size();
+		for (size_t i = 0; same && i < zones.size(); ++i) {
+			same = zones[i].name == gameState.map.zones[i].name && zones[i].x == gameState.map.zones[i].x
+				&& zones[i].y == gameState.map.zones[i].y;
+		}
+		// Tile by tile first, so layers are decoded lazily, then all at once
+		for (int x = 0; same && x < grid.dim; ++x) {
+			for (int y = 0; same && y < grid.dim; ++y) {
+				same = view.IsVisible(x, y) == grid.IsVisible(x, y) && SameObject<Tank>(view, grid, x, y)
+					&& SameObject<Bullet>(view, grid, x, y) && SameObject<Laser>(view, grid, x, y)
+					&& SameObject<Mine>(view, grid, x, y) && SameObject<Item>(view, grid, x, y);
+			}
+		}
+		const Grid& tiles = view.Tiles();
+		same = same && tiles.tanks.size() == grid.tanks.size() && tiles.bullets.size() == grid.bullets.size()
+			&& tiles.lasers.size() == grid.lasers.size() && tiles.mines.size() == grid.mines.size()
+			&& tiles.items.size() == grid.items.size();
+		mismatches += !same;
+	}
+	return mismatches;
+}
+
+void Print(const char* name, const Result& result) {
+	std::cout << name << ": mean " << result.meanMicros << " us, median " << result.medianMicros
+			  << " us, " << result.megabytesPerSecond << " MB/s, " << result.objects << " tile objects" << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <frames.jsonl> [iterations]" << std::endl;
+		return 1;
+	}
+	int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+	std::ifstream input(argv[1]);
+	std::string lobby;
+	std::vector<std::string> frames;
+	size_t totalBytes = 0;
+	for (std::string line; std::getline(input, line);) {
+		auto type = PeekPacketType(line);
+		if (type == PacketType::LobbyData && lobby.empty()) lobby = line;
+		if (type != PacketType::GameState) continue;
+		// Received frames are padded the same way, so simdjson parses them in place
+		std::string& frame = frames.emplace_back();
+		frame.reserve(line.size() + SimdjsonPacketParser::FRAME_PADDING);
+		frame = line;
+		totalBytes += frame.size();
+	}
+	if (frames.empty()) {
+		std::cerr << "No GameState frames in " << argv[1] << std::endl;
+		return 1;
+	}
+	std::cout << frames.size() << " GameState frames, " << totalBytes / frames.size() << " bytes on average" << std::endl;
+
+	Result nlohmann = Run<NlohmannPacketParser>(lobby, frames, totalBytes, iterations);
+	Result simdjson = Run<SimdjsonPacketParser>(lobby, frames, totalBytes, iterations);
+	Print("nlohmann (GameStateDecoder)", nlohmann);
+	Print("simdjson on-demand", simdjson);
+
+	if (nlohmann.objects != simdjson.objects) {
+		std::cerr << "Backends disagree on the decoded tile objects" << std::endl;
+		return 1;
+	}
+
+	size_t nlohmannViews = CheckView<NlohmannPacketParser>(lobby, frames);
+	size_t simdjsonViews = CheckView<SimdjsonPacketParser>(lobby, frames);
+	std::cout << "GameStateView mismatches: nlohmann " << nlohmannViews << ", simdjson " << simdjsonViews << std::endl;
+	if (nlohmannViews != 0 || simdjsonViews != 0) {
+		std::cerr << "GameStateView disagrees with the full decode" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "pch.h"
+#include "packet.h"
+#include "processed-packets.h"
+#include "outbound-packet.h"
+
+/// Writes the exact JSON bytes nlohmann::ordered_json used to produce for each
+/// ResponseVariant alternative, e.g.
+///   {"type":73,"payload":{"direction":0,"gameStateId":"..."}}
+/// Everything but the enum values and the gameStateId is a compile-time
+/// constant of the specialization, and the output goes into an inline
+/// OutboundPacket, so serializing an action never allocates.
+template<class T>
+struct ActionSerializer;
+
+namespace action_serializer {
+
+constexpr std::string_view GAME_STATE_ID_KEY = R"("gameStateId":")";
+constexpr std::string_view SUFFIX = R"("}})";
+
+inline bool AppendDigit(OutboundPacket& out, int value) {
+    return out.Append(static_cast<char>('0' + value));
+}
+
+inline bool AppendRotation(OutboundPacket& out, RotationDirection rotation) {
+    if (rotation == RotationDirection::none) return out.Append(std::string_view("null"));
+    return AppendDigit(out, static_cast<int>(rotation));
+}
+
+/// gameStateId as a JSON string body, escaped the same way nlohmann::json::dump does
+inline bool AppendEscaped(OutboundPacket& out, std::string_view value) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    for (char c : value) {
+        bool ok;
+        switch (c) {
+            case '"': ok = out.Append(std::string_view("\\\"")); break;
+            case '\\': ok = out.Append(std::string_view("\\\\")); break;
+            case '\b': ok = out.Append(std::string_view("\\b")); break;
+            case '\f': ok = out.Append(std::string_view("\\f")); break;
+            case '\n': ok = out.Append(std::string_view("\\n")); break;
+            case '\r': ok = out.Append(std::string_view("\\r")); break;
+            case '\t': ok = out.Append(std::string_view("\\t")); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[] = {'\\', 'u', '0', '0', HEX[(c >> 4) & 0xF], HEX[c & 0xF]};
+                    ok = out.Append(std::string_view(escaped, sizeof(escaped)));
+                } else {
+                    ok = out.Append(c);
+                }
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+inline bool AppendGameStateId(OutboundPacket& out, std::string_view gameStateId) {
+    return out.Append(GAME_STATE_ID_KEY) && AppendEscaped(out, gameStateId) && out.Append(SUFFIX);
+}
+
+}
+
+template<>
+struct ActionSerializer<Rotate> {
+    static_assert(static_cast<int>(PacketType::TankRotation) == 74);
+
+    static bool Write(const Rotate& rotate, std::string_view gameStateId, OutboundPacket& out) {
+        using namespace action_serializer;
+        return out.Append(std::string_view(R"({"type":74,"payload":{"tankRotation":)"))
+               && AppendRotation(out, rotate.tankRotation)
+               && out.Append(std::string_view(R"(,"turretRotation":)"))
+               && AppendRotation(out, rotate.turretRotation)
+               && out.Append(',')
+               && AppendGameStateId(out, gameStateId);
+    }
+};
+
+template<>
+struct ActionSerializer<Move> {
+    static_assert(static_cast<int>(PacketType::TankMovement) == 73);
+
+    static bool Write(const Move& move, std::string_view gameStateId, OutboundPacket& out) {
+        using namespace action_serializer;
+        return out.Append(std::string_view(R"({"type":73,"payload":{"direction":)"))
+               && AppendDigit(out, static_cast<int>(move.direction))
+               && out.Append(',')
+               && AppendGameStateId(out, gameStateId);
+    }
+};
+
+template<>
+struct ActionSerializer<AbilityUse> {
+    static_assert(static_cast<int>(PacketType::AbilityUse) == 75);
+
+    static bool Write(const AbilityUse& abilityUse, std::string_view gameStateId, OutboundPacket& out) {
+        using namespace action_serializer;
+        return out.Append(std::string_view(R"({"type":75,"payload":{"abilityType":)"))
+               && AppendDigit(out, static_cast<int>(abilityUse.type))
+               && out.Append(',')
+               && AppendGameStateId(out, gameStateId);
+    }
+};
+
+template<>
+struct ActionSerializer<Wait> {
+    static_assert(static_cast<int>(PacketType::ResponsePass) == 79);
+
+    static bool Write(const Wait&, std::string_view gameStateId, OutboundPacket& out) {
+        using namespace action_serializer;
+        return out.Append(std::string_view(R"({"type":79,"payload":{)"))
+               && AppendGameStateId(out, gameStateId);
+    }
+};
+
+/// Serializes any ResponseVariant into out, returns false if gameStateId does not fit
+inline bool SerializeResponse(const ResponseVariant& response, std::string_view gameStateId, OutboundPacket& out) {
+    out.Clear();
+    return std::visit([&](const auto& resp) {
+        return ActionSerializer<std::decay_t<decltype(resp)>>::Write(resp, gameStateId, out);
+    }, response);
+}
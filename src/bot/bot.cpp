@@ -6,76 +6,52 @@ void Bot::OnWarningReceived(WarningType warningType, std::optional<std::string>
 void Bot::OnGameStarting() {}
 void Bot::OnGameEnded(const EndGameLobby& endGameLobby) {}
 
-void Bot::PrintMap(const std::vector<std::vector<Tile>>& tiles) {
-    auto rows = tiles.size();
-    auto cols = tiles[0].size();
+void Bot::PrintMap(const Map& gameMap) {
+    const Grid& grid = gameMap.grid;
+    auto rows = grid.dim;
+    auto cols = grid.dim;
 
     std::vector<std::vector<std::string>> map(rows, std::vector<std::string>(cols, " "));
 
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
-            const Tile& tile = tiles[i][j];
-
-            // Check for tile objects
-            bool hasObject = false;
-            for (const TileVariant& object : tile.objects) {
-                if (std::holds_alternative<Wall>(object)) {
-                    map[i][j] = '#';
-                    hasObject = true;
-                    break; // Found wall, no need to check further
-                } else if (std::holds_alternative<Tank>(object)) {
-                    if (auto tankPtr = std::get_if<Tank>(&object)) {
-                        auto tankId = tankPtr->ownerId;
-                        // Use '@' for player's tank, 'T' for enemy tanks
-                        std::string tankSymbol = (tankId != myId) ? "T" : "@";
-                        tankSymbol += (tankPtr->direction == Direction::up) ? "^" :
-                                      (tankPtr->direction == Direction::down) ? "v" :
-                                      (tankPtr->direction == Direction::left) ? "<" : ">";
-                        map[i][j] = tankSymbol;
-                        hasObject = true;
-                        break; // Found tank, no need to check further
-                    }
-                } else if (std::holds_alternative<Item>(object)) {
-                    if (auto itemPtr = std::get_if<Item>(&object)) {
-                        map[i][j] = (itemPtr->type == ItemType::radar) ? 'R' :
-                                    (itemPtr->type == ItemType::doubleBullet) ? 'D' :
-                                    (itemPtr->type == ItemType::mine) ? 'M' : 'L';
-                        hasObject = true;
-                    }
-                } else if (std::holds_alternative<Mine>(object)) {
-                    map[i][j] = 'X';
-                    hasObject = true;
-                } else if (std::holds_alternative<Laser>(object)) {
-                    if (auto laserPtr = std::get_if<Laser>(&object)) {
-                        map[i][j] = (laserPtr->orientation == LaserOrientation::horizontal) ? '-' : '!';
-                        hasObject = true;
-                    }
-                } else if (std::holds_alternative<Bullet>(object)) {
-                    if (auto bulletPtr = std::get_if<Bullet>(&object)) {
-                        if (bulletPtr->type == BulletType::bullet) {
-                            map[i][j] = (bulletPtr->direction == Direction::up) ? "^" :
-                                        (bulletPtr->direction == Direction::down) ? "v" :
-                                        (bulletPtr->direction == Direction::left) ? "<" : ">";
-                        } else {
-                            map[i][j] = (bulletPtr->direction == Direction::up) ? "^^" :
-                                        (bulletPtr->direction == Direction::down) ? "vv" :
-                                        (bulletPtr->direction == Direction::left) ? "<<" : ">>";
-                        }
-                        hasObject = true;
-                    }
+            // Check for walls and tile objects, one symbol per tile
+            if (grid.Has(GridLayer::wall, i, j)) {
+                map[i][j] = '#';
+            } else if (auto tankPtr = grid.Find<Tank>(i, j)) {
+                auto tankId = tankPtr->ownerId;
+                // Use '@' for player's tank, 'T' for enemy tanks
+                std::string tankSymbol = (tankId != myId) ? "T" : "@";
+                tankSymbol += (tankPtr->direction == Direction::up) ? "^" :
+                              (tankPtr->direction == Direction::down) ? "v" :
+                              (tankPtr->direction == Direction::left) ? "<" : ">";
+                map[i][j] = tankSymbol;
+            } else if (auto itemPtr = grid.Find<Item>(i, j)) {
+                map[i][j] = (itemPtr->type == ItemType::radar) ? 'R' :
+                            (itemPtr->type == ItemType::doubleBullet) ? 'D' :
+                            (itemPtr->type == ItemType::mine) ? 'M' : 'L';
+            } else if (grid.Has(GridLayer::mine, i, j)) {
+                map[i][j] = 'X';
+            } else if (auto laserPtr = grid.Find<Laser>(i, j)) {
+                map[i][j] = (laserPtr->orientation == LaserOrientation::horizontal) ? '-' : '!';
+            } else if (auto bulletPtr = grid.Find<Bullet>(i, j)) {
+                if (bulletPtr->type == BulletType::bullet) {
+                    map[i][j] = (bulletPtr->direction == Direction::up) ? "^" :
+                                (bulletPtr->direction == Direction::down) ? "v" :
+                                (bulletPtr->direction == Direction::left) ? "<" : ">";
+                } else {
+                    map[i][j] = (bulletPtr->direction == Direction::up) ? "^^" :
+                                (bulletPtr->direction == Direction::down) ? "vv" :
+                                (bulletPtr->direction == Direction::left) ? "<<" : ">>";
                 }
-                break; // Stop checking objects after the first found
             }
-
             // If no object found, check for None tile properties
-            if (!hasObject) {
-                if (tile.zoneName != '?') {
-                    map[i][j] = tile.zoneName; // Print zone name
-                } else if (tile.isVisible) {
-                    map[i][j] = '.'; // Print visibility for visible None tile
-                } else {
-                    map[i][j] = ' '; // Not visible, so leave it as empty space
-                }
+            else if (gameMap.staticMap && gameMap.staticMap->ZoneName(i, j) != '?') {
+                map[i][j] = gameMap.staticMap->ZoneName(i, j); // Print zone name
+            } else if (grid.IsVisible(i, j)) {
+                map[i][j] = '.'; // Print visibility for visible None tile
+            } else {
+                map[i][j] = ' '; // Not visible, so leave it as empty space
             }
         }
     }
@@ -108,6 +84,11 @@ void Bot::Init(const LobbyData& _lobbyData) {
     myId = lobbyData.myId;
     skipResponse = lobbyData.broadcastInterval - 1;
     knowledgeMap.init(dim);
+    tickDelta.init(dim);
+    search.init(dim);
+    distances.init(dim);
+    planner.init(dim);
+    threats.init(dim);
 }
 
 ResponseVariant Bot::RandomMove(const GameState& gameState) {
@@ -150,6 +131,12 @@ ResponseVariant Bot::BeDrunkInsideZone(const GameState& gameState) {
     if (gen() % 2 == 0) {
         bool canMoveForward = canMoveForwardInsideZone(myPos);
         bool canMoveBackward = canMoveBackwardInsideZone(myPos);
+        // Out of an enemy's sight if only one way allows it
+        bool safeForward = canMoveForward && !isThreatened(afterMove(myPos, MoveDirection::forward).pos);
+        bool safeBackward = canMoveBackward && !isThreatened(afterMove(myPos, MoveDirection::backward).pos);
+        if (safeForward != safeBackward) {
+            return Move{safeForward ? MoveDirection::forward : MoveDirection::backward};
+        }
         if (canMoveForward && canMoveBackward) {
             auto randomMove = static_cast<MoveDirection>(gen() % 2);
             return Move{randomMove};
@@ -165,19 +152,58 @@ ResponseVariant Bot::BeDrunkInsideZone(const GameState& gameState) {
     return Rotate{randomRotation1, randomRotation2};
 }
 
+std::optional<ResponseVariant> Bot::QuickMove(GameStateView& view) {
+    // A destroyed tank cannot act until it regenerates, the map is not worth decoding
+    for (const Player& player : view.Players()) {
+        if (player.id == myId && player.ticksToRegen.has_value()) {
+            return Wait{};
+        }
+    }
+
+    // A tank moves at most one tile a tick, so it is on or next to the tile it was on
+    std::array<OrientedPosition, 3> candidates = {
+        myPos, afterMove(myPos, MoveDirection::forward), afterMove(myPos, MoveDirection::backward)};
+    for (const auto& candidate : candidates) {
+        if (!isValid(candidate, dim)) {
+            continue;
+        }
+        const Tank* tank = view.Find<Tank>(candidate.pos.x, candidate.pos.y);
+        if (tank == nullptr || tank->ownerId != myId) {
+            continue;
+        }
+
+        // Same as shootIfWillFireHitForSure at the start of NextMove
+        auto item = tank->secondaryItem.value_or(SecondaryItemType::unknown);
+        auto shot = shotFor(item, tank->turret.bulletCount.value_or(0), true, true);
+        if (!shot.has_value() || !willFireHitForSure(view, candidate.pos, tank->turret.direction, item)) {
+            return std::nullopt;
+        }
+        myPos = OrientedPosition(candidate.pos, tank->direction);
+        return shot;
+    }
+    return std::nullopt;
+}
+
 ResponseVariant Bot::NextMove(const GameState& gameState) {
     // clock_t start = clock();
 
     std::random_device rd;
     std::mt19937 gen(rd());
 
-    if (gameState.time == 1) {
-        onFirstNextMove(gameState);
+    staticMap = gameState.map.staticMap;
+    if (staticDistances.source() != staticMap.get()) {
+        // Does not wait for the table, see StaticDistances::isReady
+        staticDistances.start(staticMap);
     }
 
     auto lastPos = myPos;
     initMyTank(gameState);
-    knowledgeMap.update(gameState);
+    tickDelta.update(gameState.map.grid);
+    knowledgeMap.update(gameState, tickDelta);
+    gridLines.update(gameState.map.grid, myId);
+    distances.invalidate();
+    planner.update(knowledgeMap, *staticMap);
+    threats.update(knowledgeMap, *staticMap, myId);
 
     std::optional<ResponseVariant> response;
 
@@ -194,7 +220,7 @@ ResponseVariant Bot::NextMove(const GameState& gameState) {
         return BeDrunkInsideZone(gameState);
     }
 
-    auto bullet = closestBullet(gameState, myPos.pos);
+    auto bullet = closestBullet(gridLines, myPos.pos);
     auto isOnBulletLine = [&](const OrientedPosition& oPos, int timer) {
         return oPos.pos.x != bullet.x && oPos.pos.y != bullet.y;
     };
@@ -228,18 +254,18 @@ ResponseVariant Bot::NextMove(const GameState& gameState) {
     {
         // std::cout << "[DEBUG] Zone 1 is owned by the player. Targeting Zone 2.\n";
         // std ::cout << " > Targeting: " << zone_2.name << std::endl;
-        isZone = targetZone(zone_2.name, zoneName);
+        isZone = targetZone(zone_2.name, *staticMap);
     }
     else if (isZoneCapturedByPlayer(zone_2, myId) && myTank.health.value() % 20 == 1)
     {
         // std::cout << "[DEBUG] Zone 2 is owned by the player. Targeting Zone 1.\n";
         // std::cout << " > Targeting: " << zone_1.name << std::endl;
-        isZone = targetZone(zone_1.name, zoneName);
+        isZone = targetZone(zone_1.name, *staticMap);
     }
     else
     {
         std::cout << "[DEBUG] No specific conditions met. Targeting any zone.\n";
-        isZone = targetAnyZone(zoneName);
+        isZone = targetAnyZone(*staticMap);
     }
     if (isZone(myPos, 0))
     {
@@ -252,6 +278,16 @@ ResponseVariant Bot::NextMove(const GameState& gameState) {
             return response.value();
         }
 
+        if (isThreatened(myPos.pos)) {
+            // Camp on a tile of the zone no enemy can shoot soon
+            response = bfsStrategy(gameState, [&](const OrientedPosition& pos, int timer) {
+                return isZone(pos, timer) && !isThreatened(pos.pos);
+            });
+            if (response.has_value()) {
+                return response.value();
+            }
+        }
+
         return BeDrunkInsideZone(gameState);
     }
 
@@ -263,39 +299,12 @@ ResponseVariant Bot::NextMove(const GameState& gameState) {
     return BeDrunkInsideZone(gameState);
 }
 
-void Bot::initIsWall(const std::vector<std::vector<Tile>>& tiles) {
-    isWall = std::vector<std::vector<bool>>(dim, std::vector<bool>(dim, false));
-    for (int i = 0; i < dim; ++i) {
-        for (int j = 0; j < dim; ++j) {
-            isWall[i][j] = std::any_of(tiles[i][j].objects.begin(), tiles[i][j].objects.end(), [](const TileVariant& object) {
-                return std::holds_alternative<Wall>(object);
-            });
-        }
-    }
-}
-
-void Bot::initZoneName(const std::vector<std::vector<Tile>>& tiles) {
-    zoneName = std::vector<std::vector<char>>(dim, std::vector<char>(dim, '?'));
-    for (int i = 0; i < dim; ++i) {
-        for (int j = 0; j < dim; ++j) {
-            zoneName[i][j] = tiles[i][j].zoneName;
-        }
-    }
-}
-
 void Bot::initMyTankHelper(const GameState& gameState) {
-    for (int i = 0; i < dim; i++) {
-        for (int j = 0; j < dim; j++) {
-            for (const TileVariant& object : gameState.map.tiles[i][j].objects) {
-                if (std::holds_alternative<Tank>(object)) {
-                    const Tank& tank = std::get<Tank>(object);
-                    if (tank.ownerId == myId) {
-                        myTank = tank;
-                        myPos = OrientedPosition{Position(i, j), tank.direction};
-                        return;
-                    }
-                }
-            }
+    for (const auto& [x, y, tank] : gameState.map.grid.tanks) {
+        if (tank.ownerId == myId) {
+            myTank = tank;
+            myPos = OrientedPosition{Position(x, y), tank.direction};
+            return;
         }
     }
 }
@@ -308,89 +317,76 @@ void Bot::initMyTank(const GameState& gameState) {
     myBulletCount = myTank.turret.bulletCount.value();
 }
 
-void Bot::onFirstNextMove(const GameState& gameState) {
-    initIsWall(gameState.map.tiles);
-    initZoneName(gameState.map.tiles);
-}
-
 bool Bot::canSeeEnemy(const GameState& gameState) const {
-    int x = myPos.pos.x;
-    int y = myPos.pos.y;
-    int dir = getDirId(myTurretDir);
-
-    auto [dx, dy] = Position::DIRECTIONS[dir];
+    return enemyAlongTurret(gridLines.enemies[0]).has_value() || enemyAlongTurret(gridLines.enemies[1]).has_value();
+}
 
-    for (int i = 1; i < dim; ++i) {
-        x += dx;
-        y += dy;
-        if (!isValid(Position(x, y), dim)) {
-            break;
-        }
-        if (isWall[x][y]) {
-            break;
-        }
-        if (!gameState.map.tiles[x][y].isVisible) {
-            break;
-        }
-        for (const TileVariant& object : gameState.map.tiles[x][y].objects) {
-            if (std::holds_alternative<Tank>(object)) {
-                const Tank& tank = std::get<Tank>(object);
-                if (tank.ownerId != myId) {
-                    return true;
-                }
-            }
-        }
+bool Bot::willFireHitForSure(const GameState& gameState) const {
+    int bound = 2;
+    if (heldItem == SecondaryItemType::Laser) {
+        bound = dim;
     }
 
-    return false;
+    // Only tanks facing along the shot cannot dodge it
+    auto enemy = enemyAlongTurret(gridLines.enemies[getDirId(myTurretDir) % 2]);
+    return enemy.has_value() && *enemy < bound;
 }
 
-bool Bot::willFireHitForSure(const GameState& gameState) const {
-    int x = myPos.pos.x;
-    int y = myPos.pos.y;
-    int dir = getDirId(myTurretDir);
+bool Bot::willFireHitForSure(GameStateView& view, const Position& pos, Direction turretDir, SecondaryItemType item) const {
+    const StaticMap* walls = view.Static();
+    if (walls == nullptr) {
+        return false;
+    }
 
-    auto [dx, dy] = Position::DIRECTIONS[dir];
+    int x = pos.x;
+    int y = pos.y;
+    auto [dx, dy] = Position::DIRECTIONS[getDirId(turretDir)];
 
     int bound = 2;
-    if (heldItem == SecondaryItemType::Laser) {
+    if (item == SecondaryItemType::Laser) {
         bound = dim;
     }
 
     for (int i = 1; i < bound; i++) {
         x += dx;
         y += dy;
-        if (!isValid(Position(x, y), dim)) {
-            break;
-        }
-        if (isWall[x][y]) {
-            break;
-        }
-        if (!gameState.map.tiles[x][y].isVisible) {
+        if (!isValid(Position(x, y), dim) || walls->IsWall(x, y) || !view.IsVisible(x, y)) {
             break;
         }
-        for (const TileVariant& object : gameState.map.tiles[x][y].objects) {
-            if (std::holds_alternative<Tank>(object)) {
-                const Tank& tank = std::get<Tank>(object);
-                if (tank.ownerId == myId) {
-                    continue;
-                }
-                if (isParallel(myTurretDir, tank.direction)) {
-                    return true;
-                }
-            }
+        auto isHittableEnemy = [&](const Tank& tank) {
+            return tank.ownerId != myId && isParallel(turretDir, tank.direction);
+        };
+        if (view.Any<Tank>(x, y, isHittableEnemy)) {
+            return true;
         }
     }
 
     return false;
 }
 
+std::optional<int> Bot::enemyAlongTurret(const LineBoard& enemies) const {
+    int x = myPos.pos.x;
+    int y = myPos.pos.y;
+    int dir = getDirId(myTurretDir);
+
+    auto enemy = enemies.firstSet(x, y, dir);
+    if (!enemy) {
+        return std::nullopt;
+    }
+    auto wall = knowledgeMap.walls.firstSet(x, y, dir);
+    auto hidden = gridLines.visible.firstClear(x, y, dir);
+    if ((wall && *wall <= *enemy) || (hidden && *hidden <= *enemy)) {
+        return std::nullopt;
+    }
+    return enemy;
+}
+
 bool Bot::canMoveForwardInsideZone(const OrientedPosition& pos) const {
     auto [dx, dy] = Position::DIRECTIONS[getDirId(pos.dir)];
     auto nextPos = pos;
     nextPos.pos.x += dx;
     nextPos.pos.y += dy;
-    return isValid(nextPos.pos, dim) && !isWall[nextPos.pos.x][nextPos.pos.y] && zoneName[nextPos.pos.x][nextPos.pos.y] != '?';
+    return isValid(nextPos.pos, dim) && !staticMap->IsWall(nextPos.pos.x, nextPos.pos.y) && staticMap->ZoneName(nextPos.pos.x, nextPos.pos.y) != '?';
 }
 
 bool Bot::canMoveBackwardInsideZone(const OrientedPosition& pos) const {
@@ -398,7 +394,7 @@ bool Bot::canMoveBackwardInsideZone(const OrientedPosition& pos) const {
     auto nextPos = pos;
     nextPos.pos.x -= dx;
     nextPos.pos.y -= dy;
-    return isValid(nextPos.pos, dim) && !isWall[nextPos.pos.x][nextPos.pos.y] && zoneName[nextPos.pos.x][nextPos.pos.y] != '?';
+    return isValid(nextPos.pos, dim) && !staticMap->IsWall(nextPos.pos.x, nextPos.pos.y) && staticMap->ZoneName(nextPos.pos.x, nextPos.pos.y) != '?';
 }
 
 std::optional<ResponseVariant> Bot::dropMineIfPossible(const GameState& gameState) {
@@ -412,11 +408,13 @@ std::optional<ResponseVariant> Bot::dropMineIfPossible(const GameState& gameStat
     minePos.x -= dx;
     minePos.y -= dy;
 
-    if (!isValid(minePos, dim) || isWall[minePos.x][minePos.y]) {
+    if (!isValid(minePos, dim) || staticMap->IsWall(minePos.x, minePos.y)) {
         return std::nullopt;
     }
 
     knowledgeMap.notifyMine(gameState, minePos);
+    // The mine blocks its tile from now on
+    distances.invalidate();
 
     std::cerr << "[EVENT] Dropping mine at " << minePos.x << " " << minePos.y << std::endl;
 
@@ -424,18 +422,19 @@ std::optional<ResponseVariant> Bot::dropMineIfPossible(const GameState& gameStat
 }
 
 std::optional<ResponseVariant> Bot::dropMineIfReasonable(const GameState& gameState) {
-    if (heldItem == SecondaryItemType::Mine && (isBetweenWalls(myPos.pos, isWall, dim) || zoneName[myPos.pos.x][myPos.pos.y] != '?')) {
+    if (heldItem == SecondaryItemType::Mine && (isBetweenWalls(myPos.pos, staticMap->walls, dim) || staticMap->ZoneName(myPos.pos.x, myPos.pos.y) != '?')) {
         auto [dx, dy] = Position::DIRECTIONS[getDirId(myPos.dir)];
 
         Position minePos = myPos.pos;
         minePos.x -= dx;
         minePos.y -= dy;
 
-        if (!isValid(minePos, dim) || isWall[minePos.x][minePos.y]) {
+        if (!isValid(minePos, dim) || staticMap->IsWall(minePos.x, minePos.y)) {
             return std::nullopt;
         }
 
         knowledgeMap.notifyMine(gameState, minePos);
+        distances.invalidate();
 
         return AbilityUse{AbilityType::dropMine};
     }
@@ -456,18 +455,22 @@ std::optional<ResponseVariant> Bot::goForItem(const GameState& gameState) {
         auto isItem = [&](const OrientedPosition& oPos, int timer) {
             int DOUBLE_BULLET_RANGE = 4;
             int OTHER_ITEM_RANGE = 10;
-            for (const TileVariant& object : gameState.map.tiles[oPos.pos.x][oPos.pos.y].objects) {
-                if (std::holds_alternative<Item>(object) && std::get<Item>(object).type == ItemType::mine) {
-                    if (timer < OTHER_ITEM_RANGE) return true;
-                } else if (std::holds_alternative<Item>(object) && std::get<Item>(object).type == ItemType::radar) {
-                    if (timer < OTHER_ITEM_RANGE) return true;
-                } else if (std::holds_alternative<Item>(object) && std::get<Item>(object).type == ItemType::doubleBullet) {
-                    if (timer < DOUBLE_BULLET_RANGE) return true;
-                } else if (std::holds_alternative<Item>(object) && std::get<Item>(object).type == ItemType::laser) {
-                    if (timer < OTHER_ITEM_RANGE) return true;
+            auto isInRange = [&](const Item& item) {
+                if (item.type == ItemType::mine) {
+                    return timer < OTHER_ITEM_RANGE;
+                } else if (item.type == ItemType::radar) {
+                    return timer < OTHER_ITEM_RANGE;
+                } else if (item.type == ItemType::doubleBullet) {
+                    return timer < DOUBLE_BULLET_RANGE;
+                } else if (item.type == ItemType::laser) {
+                    return timer < OTHER_ITEM_RANGE;
                 }
+                return false;
+            };
+            if (gameState.map.grid.Any<Item>(oPos.pos.x, oPos.pos.y, isInRange)) {
+                return true;
             }
-            for (auto object : knowledgeMap.tiles[oPos.pos.x][oPos.pos.y].objects)
+            for (const auto& object : knowledgeMap.tile(oPos.pos.x, oPos.pos.y))
             {
                 if (std::holds_alternative<Item>(object.object) && std::get<Item>(object.object).type == ItemType::mine)
                 {
@@ -519,26 +522,19 @@ std::optional<ResponseVariant> Bot::shootIfWillFireHitForSure(
 
 std::optional<ResponseVariant> Bot::rotateToEnemy(const GameState& gameState) {
     auto isVisibleEnemy = [&](const OrientedPosition& pos, int timer) {
-        if (!gameState.map.tiles[pos.pos.x][pos.pos.y].isVisible)
+        if (!gameState.map.grid.IsVisible(pos.pos.x, pos.pos.y))
             return false;
 
-        for (const TileVariant& object : gameState.map.tiles[pos.pos.x][pos.pos.y].objects) {
-            if (std::holds_alternative<Tank>(object)) {
-                const Tank& tank = std::get<Tank>(object);
-                if (tank.ownerId != myId) {
-                    return true;
-                }
-            }
-        }
-
-        return false;
+        return gameState.map.grid.Any<Tank>(pos.pos.x, pos.pos.y, [&](const Tank& tank) {
+            return tank.ownerId != myId;
+        });
     };
 
     auto isPotentialEnemy = [&](const OrientedPosition& pos, int timer) {
-        if (gameState.map.tiles[pos.pos.x][pos.pos.y].isVisible)
+        if (gameState.map.grid.IsVisible(pos.pos.x, pos.pos.y))
             return false;
 
-        for (const KnowledgeTileVariant& object : knowledgeMap.tiles[pos.pos.x][pos.pos.y].objects) {
+        for (const KnowledgeTileVariant& object : knowledgeMap.tile(pos.pos.x, pos.pos.y)) {
             if (std::holds_alternative<Tank>(object.object)) {
                 const Tank& tank = std::get<Tank>(object.object);
                 if (tank.ownerId != myId) {
@@ -605,7 +601,7 @@ std::optional<ResponseVariant> Bot::rotateToEnemy(const GameState& gameState) {
 
         if (gen() % 4 != 0) {
             auto nxtPos = afterMove(myPos, MoveDirection::forward);
-            if (isValid(nxtPos.pos, dim) && !isWall[nxtPos.pos.x][nxtPos.pos.y]) {
+            if (isValid(nxtPos.pos, dim) && !staticMap->IsWall(nxtPos.pos.x, nxtPos.pos.y)) {
                 return Move{MoveDirection::forward};
             }
             return BeDrunkInsideZone(gameState);
@@ -614,7 +610,7 @@ std::optional<ResponseVariant> Bot::rotateToEnemy(const GameState& gameState) {
         auto nxtPos = afterMove(myPos, MoveDirection::backward);
         switch (gen() % 3) {
             case 0:
-                if (isValid(nxtPos.pos, dim) && !isWall[nxtPos.pos.x][nxtPos.pos.y]) {
+                if (isValid(nxtPos.pos, dim) && !staticMap->IsWall(nxtPos.pos.x, nxtPos.pos.y)) {
                     return Move{MoveDirection::backward};
                 }
                 return BeDrunkInsideZone(gameState);
@@ -628,42 +624,59 @@ std::optional<ResponseVariant> Bot::rotateToEnemy(const GameState& gameState) {
     return Rotate{tankRot, turretRot};
 }
 
-bool Bot::willBeHitByBullet(const GameState& gameState, const OrientedPosition& pos) const {
+bool Bot::willBeHitByBullet(const OrientedPosition& pos) const {
     int x = pos.pos.x;
     int y = pos.pos.y;
-    return knowledgeMap.willBeHitByBulletInNextMove(x, y);
+    return knowledgeMap.danger.isReachedWithin(x, y, 1);
+}
+
+bool Bot::isThreatened(const Position& pos) const {
+    return threats.isReachedWithin(pos.x, pos.y, THREAT_TICKS);
+}
+
+bool Bot::isBlocked(int x, int y, int eta) const {
+    return staticMap->IsWall(x, y) || knowledgeMap.containsMine(Position(x, y)) || knowledgeMap.danger.isReachedWithin(x, y, eta);
+}
+
+ResponseVariant Bot::responseFor(const MoveOrRotation& action) {
+    if (std::holds_alternative<MoveDirection>(action)) {
+        return Move{std::get<MoveDirection>(action)};
+    }
+    return Rotate{std::get<RotationDirection>(action), RotationDirection::none};
 }
 
 bool Bot::knowWhereIs(const TileVariant& object, const GameState& gamestate) const {
-    for (auto row: gamestate.map.tiles) {
-        for (auto tile: row) {
-            for (auto obj: tile.objects) {
-                if (obj.index() == object.index()) {
-                    if (std::holds_alternative<Tank>(obj)) {
-                        if (std::get<Tank>(obj).ownerId != myId) {
-                            return true;
-                        }
-                    } else {
-                        return true;
-                    }
-                }
-            }
+    const Grid& grid = gamestate.map.grid;
+    bool onGrid = std::visit([&](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, Wall>) {
+            return false;
+        } else if constexpr (std::is_same_v<T, Tank>) {
+            return std::any_of(grid.tanks.begin(), grid.tanks.end(), [&](const auto& entry) {
+                return entry.object.ownerId != myId;
+            });
+        } else {
+            return !grid.Objects<T>().empty();
         }
+    }, object);
+    if (onGrid) {
+        return true;
     }
-    for (auto row: knowledgeMap.tiles) {
-        for (auto tile: row) {
-            for (auto obj: tile.objects) {
-                if (obj.object.index() == object.index()) {
-                    if (std::holds_alternative<Tank>(obj.object)) {
-                        if (std::get<Tank>(obj.object).ownerId != myId) {
-                            return true;
-                        }
-                    } else {
-                        return true;
-                    }
+    // Only tiles with knowledge can remember it
+    bool found = false;
+    knowledgeMap.known.ForEach([&](int x, int y) {
+        for (const auto& obj : knowledgeMap.tile(x, y)) {
+            if (found) {
+                return;
+            }
+            if (obj.object.index() == object.index()) {
+                if (std::holds_alternative<Tank>(obj.object)) {
+                    found = std::get<Tank>(obj.object).ownerId != myId;
+                } else {
+                    found = true;
                 }
             }
         }
-    }
-    return false;
+    });
+    return found;
 }
@@ -1,7 +1,13 @@
 #pragma once
 
 #include "../processed-packets.h"
+#include "../game-state-view.h"
 #include "utils.h"
+#include "search-workspace.h"
+#include "distance-field.h"
+#include "static-distances.h"
+#include "space-time-planner.h"
+#include "threat-field.h"
 
 #include <vector>
 
@@ -11,15 +17,17 @@ class Bot {
     /// DO NOT DELETE
     /// time in milliseconds after which the NextMove() answer is not sent to server, CAN BE CHANGED WHENEVER YOU WANT
     int skipResponse = 99;
-	std::string myId;
+	PlayerId myId;
 
 	Bot();
 	void Init(const LobbyData& _lobbyData);
 	ResponseVariant NextMove(const GameState& gameState);
+	/// Called before the GameState is decoded, a response skips decoding it and NextMove
+	std::optional<ResponseVariant> QuickMove(GameStateView& view);
 	void OnGameEnded(const EndGameLobby& endGameLobby);
     void OnWarningReceived(WarningType warningType, std::optional<std::string>& message);
     void OnGameStarting();
-	void PrintMap(const std::vector<std::vector<Tile>>& tiles);
+	void PrintMap(const Map& gameMap);
 
     /// END
 
@@ -29,8 +37,22 @@ class Bot {
     LobbyData lobbyData;
     int dim;
     KnowledgeMap knowledgeMap;
-    std::vector<std::vector<bool>> isWall;
-    std::vector<std::vector<char>> zoneName;
+    /// Changes since the previous tick, feeds knowledgeMap
+    TickDelta tickDelta;
+    /// Walls and zones of the match, shared with the parser
+    std::shared_ptr<const StaticMap> staticMap;
+    /// Memory of bfs, sized by Init
+    SearchWorkspace search;
+    /// Search from myPos shared by every bfs of the tick that starts there
+    DistanceField distances;
+    /// Distances over the walls alone, filled in the background from the first tick of a match
+    StaticDistances staticDistances;
+    /// Paths around the bullets and lasers of this tick, used by bfsStrategy
+    SpaceTimePlanner planner;
+    /// Ray queries on the grid of this tick
+    GridLines gridLines;
+    /// How soon enemies can shoot each tile, keeps zone camping out of firing lines
+    ThreatField threats;
     // std::vector<GameState> statesSnapshots;
     Tank myTank;
     OrientedPosition myPos;
@@ -59,19 +81,28 @@ class Bot {
 
     std::optional<ResponseVariant> rotateToEnemy(const GameState& gameState);
 
-    void onFirstNextMove(const GameState& gameState);
-    void initIsWall(const std::vector<std::vector<Tile>>& tiles);
-    void initZoneName(const std::vector<std::vector<Tile>>& tiles);
     void initMyTank(const GameState& gameState);
     void initMyTankHelper(const GameState& gameState);
 
     bool canSeeEnemy(const GameState& gameState) const;
     bool willFireHitForSure(const GameState& gameState) const;
-    bool willBeHitByBullet(const GameState& gameState, const OrientedPosition& pos) const;
+    /// willFireHitForSure for a tank on pos read from view, decodes only the tiles on the line of fire
+    bool willFireHitForSure(GameStateView& view, const Position& pos, Direction turretDir, SecondaryItemType item) const;
+    /// Tiles to the first of enemies in sight of the turret, std::nullopt if none
+    std::optional<int> enemyAlongTurret(const LineBoard& enemies) const;
+    bool willBeHitByBullet(const OrientedPosition& pos) const;
 
     bool canMoveForwardInsideZone(const OrientedPosition& pos) const;
     bool canMoveBackwardInsideZone(const OrientedPosition& pos) const;
     bool knowWhereIs(const TileVariant& object, const GameState& gamestate) const;
+    /// Ticks ahead in which an enemy able to shoot a tile makes camping on it unsafe
+    static constexpr int THREAT_TICKS = 3;
+    /// Tiles bfs does not enter when it would arrive there in eta ticks
+    bool isBlocked(int x, int y, int eta) const;
+    /// An enemy can shoot pos within THREAT_TICKS
+    bool isThreatened(const Position& pos) const;
+    /// Tank move or rotation doing action, the turret stays
+    static ResponseVariant responseFor(const MoveOrRotation& action);
 
     struct BfsResult {
         MoveOrRotation move;
@@ -81,19 +112,30 @@ class Bot {
 
     template<class F>
     std::optional<BfsResult> bfs(const OrientedPosition& start, F&& f) {
-        std::queue<std::pair<OrientedPosition, int>> q;
-        std::vector<std::vector<std::vector<bool>>> visited(dim, std::vector<std::vector<bool>>(dim, std::vector<bool>(4, false)));
-        std::vector<std::vector<std::vector<MoveOrRotation>>> from(dim, std::vector<std::vector<MoveOrRotation>>(dim, std::vector<MoveOrRotation>(4))); // i, j, dir
-        q.push({start, 0});
-        visited[start.pos.x][start.pos.y][getDirId(start.dir)] = true;
+        if (start == myPos) {
+            if (!distances.isBuilt()) {
+                distances.build(myPos, [&](int x, int y, int eta) { return isBlocked(x, y, eta); });
+            }
+            auto hit = distances.nearest(f);
+            if (!hit) {
+                return std::nullopt;
+            }
+            return BfsResult{ALL_ACTIONS[hit->firstAction], hit->pos, hit->eta};
+        }
+
+        search.begin();
+        uint32_t startState = search.state(start);
+        // Reached by no action, read back as the reversed forward move like a default MoveOrRotation
+        search.visit(startState, 0);
+        search.push(startState, 0);
 
         bool found = false;
         OrientedPosition finish;
         int eta = -1;
 
-        while (!q.empty()) {
-            auto [pos, timer] = q.front();
-            q.pop();
+        while (!search.empty()) {
+            auto [current, timer] = search.pop();
+            OrientedPosition pos = search.position(current);
 
             if (f(pos, timer)) {
                 found = true;
@@ -102,35 +144,19 @@ class Bot {
                 break;
             }
 
-            for (const MoveOrRotation &move : ALL_ACTIONS) {
-                auto nextPos = afterMove(pos, move);
+            for (int action = 0; action < 4; ++action) {
+                auto nextPos = afterAction(pos, action);
                 if (!isValid(nextPos, dim)) {
                     continue;
                 }
 
-                int x = nextPos.pos.x;
-                int y = nextPos.pos.y;
-                int dir = getDirId(nextPos.dir);
-
-                if (isWall[x][y]) {
-                    continue;
-                }
-
-                if (knowledgeMap.containsMine(nextPos.pos)) {
-                    continue;
-                }
-
-                if (knowledgeMap.isOnBulletTraj(x, y)) {
-                    continue;
-                }
-
-                if (visited[x][y][dir]) {
+                uint32_t next = search.state(nextPos);
+                if (search.visited(next) || isBlocked(nextPos.pos.x, nextPos.pos.y, timer + 1)) {
                     continue;
                 }
 
-                visited[x][y][dir] = true;
-                from[x][y][dir] = reversed(move);
-                q.push({nextPos, timer + 1});
+                search.visit(next, reversedActionId(action));
+                search.push(next, timer + 1);
             }
         }
 
@@ -139,15 +165,14 @@ class Bot {
         }
 
         OrientedPosition cur = finish;
-        MoveOrRotation lastMove = from[cur.pos.x][cur.pos.y][getDirId(cur.dir)];
+        int lastMove = search.from(search.state(cur));
 
         while (cur != start) {
-            lastMove = from[cur.pos.x][cur.pos.y][getDirId(cur.dir)];
-            cur.move(lastMove);
+            lastMove = search.from(search.state(cur));
+            cur = afterAction(cur, lastMove);
         }
 
-        lastMove = reversed(lastMove);
-        return BfsResult{lastMove, finish, eta};
+        return BfsResult{ALL_ACTIONS[reversedActionId(lastMove)], finish, eta};
     }
 
     template<class F>
@@ -157,26 +182,36 @@ class Bot {
             bool useLaserIfPossible = true, 
             bool useDoubleBulletIfPossible = true
     ) {
-        bool ignoreBulletCount = (heldItem == SecondaryItemType::DoubleBullet && useDoubleBulletIfPossible);
-        ignoreBulletCount |=     (heldItem == SecondaryItemType::Laser && useLaserIfPossible);
-
-        if (myBulletCount == 0 && !ignoreBulletCount)
-        {
+        auto shot = shotFor(heldItem, myBulletCount, useLaserIfPossible, useDoubleBulletIfPossible);
+        if (!shot.has_value() || !f(gameState)) {
             return std::nullopt;
         }
+        return shot;
+    }
 
-        if (!f(gameState)) {
+    /// Shot a tank holding item and bulletCount bullets fires, std::nullopt if it cannot fire
+    static std::optional<ResponseVariant> shotFor(
+            SecondaryItemType item,
+            int bulletCount,
+            bool useLaserIfPossible,
+            bool useDoubleBulletIfPossible
+    ) {
+        bool ignoreBulletCount = (item == SecondaryItemType::DoubleBullet && useDoubleBulletIfPossible);
+        ignoreBulletCount |=     (item == SecondaryItemType::Laser && useLaserIfPossible);
+
+        if (bulletCount == 0 && !ignoreBulletCount)
+        {
             return std::nullopt;
         }
 
-        if (useLaserIfPossible && heldItem == SecondaryItemType::Laser) {
+        if (useLaserIfPossible && item == SecondaryItemType::Laser) {
             return AbilityUse{AbilityType::useLaser};
         }
 
-        if (useDoubleBulletIfPossible && heldItem == SecondaryItemType::DoubleBullet) {
+        if (useDoubleBulletIfPossible && item == SecondaryItemType::DoubleBullet) {
             return AbilityUse{AbilityType::fireDoubleBullet};
         }
-        
+
         return AbilityUse{AbilityType::fireBullet};
     }
 
@@ -187,22 +222,30 @@ class Bot {
             return std::nullopt;
         }
 
+        // Bullets pass, the planned path waits or goes around them instead of treating their lines as walls
+        auto isStaticObstacle = [&](int x, int y) {
+            return staticMap->IsWall(x, y) || knowledgeMap.containsMine(Position(x, y));
+        };
+        auto planned = planner.plan(myPos, result->finalPos.pos, staticDistances, isStaticObstacle, dim * dim * 8);
+        if (planned == WAIT_ACTION) {
+            return Wait{};
+        }
+        if (planned.has_value()) {
+            return responseFor(ALL_ACTIONS[*planned]);
+        }
+
         auto nxtMove = result->move;
         auto eta = result->eta;
         auto nextPos = afterMove(myPos, nxtMove);
 
-        bool hitNow = willBeHitByBullet(gameState, myPos);
-        bool hitNxt = willBeHitByBullet(gameState, nextPos);
+        bool hitNow = willBeHitByBullet(myPos);
+        bool hitNxt = willBeHitByBullet(nextPos);
 
         if (hitNxt && !hitNow) {
             // TODO: wait or think about rotating?
             return Wait{};
         }
 
-        if (std::holds_alternative<MoveDirection>(nxtMove)) {
-            return Move{std::get<MoveDirection>(nxtMove)};
-        } else {
-            return Rotate{std::get<RotationDirection>(nxtMove), RotationDirection::none};
-        }
+        return responseFor(nxtMove);
     }
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "line-board.h"
+#include "tick-field.h"
+
+/// Earliest tick from now at which each tile is lethal, rebuilt by every
+/// KnowledgeMap::update. Bullets are swept forward at their speed up to the
+/// first wall, lasers and exploding mines are lethal at once.
+class DangerMap : public TickField {
+public:
+    /// Marks every tile a bullet on (x, y) flies over before it reaches a wall,
+    /// dir is the index of its direction, speed in tiles per tick
+    void addBullet(int x, int y, int dir, double speed, const LineBoard& walls) {
+        if (walls.test(x, y)) {
+            // Remembered on a wall, it is gone
+            return;
+        }
+        speed = speed > 0 ? speed : 2;
+        mark(x, y, 0);
+
+        // Tiles up to the first wall, or up to the edge of the map
+        int toEdge = dir == 0 ? x : dir == 1 ? dim - 1 - y : dir == 2 ? dim - 1 - x : y;
+        auto wall = walls.firstSet(x, y, dir);
+        int run = wall ? *wall - 1 : toEdge;
+        // Position::DIRECTIONS order: up, right, down, left
+        int dx = dir == 0 ? -1 : dir == 2 ? 1 : 0;
+        int dy = dir == 1 ? 1 : dir == 3 ? -1 : 0;
+        for (int distance = 1; distance <= run; ++distance) {
+            mark(x + dx * distance, y + dy * distance, static_cast<int>(std::ceil(distance / speed)));
+        }
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "search-workspace.h"
+
+/// Complete search from one oriented position, kept for the rest of the tick.
+/// The states are recorded in the order the search reached them, together
+/// with their distance and the first action of the path to them. Replaying
+/// that order gives the same answer as a search stopping at the first state
+/// satisfying a predicate, so every goal-seeking strategy of a tick shares one
+/// traversal.
+class DistanceField {
+public:
+    struct Hit {
+        OrientedPosition pos;
+        int eta;
+        /// Index in ALL_ACTIONS of the first action towards pos
+        int firstAction;
+    };
+
+    void init(int dim) {
+        this->dim = dim;
+        search.init(dim);
+        size_t states = static_cast<size_t>(dim) * dim * 4;
+        distances.assign(states, 0);
+        firstActions.assign(states, 0);
+        built = false;
+    }
+
+    /// The next query needs a new build
+    void invalidate() {
+        built = false;
+    }
+
+    bool isBuilt() const {
+        return built;
+    }
+
+    const OrientedPosition& origin() const {
+        return start;
+    }
+
+    /// Searches every state reachable from start through tiles blocked(x, y, eta)
+    /// rejects, eta being the tick the search would arrive there
+    template<class Blocked>
+    void build(const OrientedPosition& start, Blocked&& blocked) {
+        this->start = start;
+        search.begin();
+        uint32_t startState = search.state(start);
+        search.visit(startState, 0);
+        search.push(startState, 0);
+        distances[startState] = 0;
+        // What Bot::bfs reports when the start itself is the goal
+        firstActions[startState] = reversedActionId(0);
+
+        while (!search.empty()) {
+            auto [current, timer] = search.pop();
+            OrientedPosition pos = search.position(current);
+
+            for (int action = 0; action < 4; ++action) {
+                auto nextPos = afterAction(pos, action);
+                if (!isValid(nextPos, dim)) {
+                    continue;
+                }
+
+                uint32_t next = search.state(nextPos);
+                if (search.visited(next) || blocked(nextPos.pos.x, nextPos.pos.y, timer + 1)) {
+                    continue;
+                }
+
+                search.visit(next, reversedActionId(action));
+                search.push(next, timer + 1);
+                distances[next] = timer + 1;
+                firstActions[next] = current == startState ? action : firstActions[current];
+            }
+        }
+        built = true;
+    }
+
+    /// First state in search order for which f(pos, eta) holds
+    template<class F>
+    std::optional<Hit> nearest(F&& f) const {
+        for (const auto& [state, timer] : search.reached()) {
+            OrientedPosition pos = search.position(state);
+            if (f(pos, timer)) {
+                return Hit{pos, timer, firstActions[state]};
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Number of actions to reach pos, std::nullopt if it cannot be reached
+    std::optional<int> eta(const OrientedPosition& pos) const {
+        uint32_t state = search.state(pos);
+        if (!search.visited(state)) {
+            return std::nullopt;
+        }
+        return distances[state];
+    }
+
+    /// Number of actions to reach pos facing any direction
+    std::optional<int> eta(const Position& pos) const {
+        std::optional<int> best;
+        for (int dir = 0; dir < 4; ++dir) {
+            auto time = eta(OrientedPosition(pos, static_cast<Direction>(dir)));
+            if (time && (!best || *time < *best)) {
+                best = time;
+            }
+        }
+        return best;
+    }
+
+    /// First action of a shortest path to pos, std::nullopt if it cannot be reached
+    std::optional<MoveOrRotation> firstMoveTowards(const OrientedPosition& pos) const {
+        uint32_t state = search.state(pos);
+        if (!search.visited(state)) {
+            return std::nullopt;
+        }
+        return ALL_ACTIONS[firstActions[state]];
+    }
+
+private:
+    int dim = 0;
+    bool built = false;
+    OrientedPosition start;
+    SearchWorkspace search;
+    std::vector<int> distances;
+    std::vector<uint8_t> firstActions;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../processed-packets.h"
+
+/// Bits of a dim x dim map regrouped by line: row x holds bit y of tile
+/// (x, y) and column y holds bit x, each line in (dim + 63) / 64 words. A ray
+/// from a tile along a row or a column is answered by a count of leading or
+/// trailing zeros per word instead of stepping tile by tile.
+class LineBoard {
+public:
+    void resize(int dim) {
+        this->dim = dim;
+        lineWords = (dim + 63) / 64;
+        rows.assign(static_cast<size_t>(dim) * lineWords, 0);
+        columns.assign(static_cast<size_t>(dim) * lineWords, 0);
+    }
+
+    /// Clears every bit, keeps the size
+    void clear() {
+        std::fill(rows.begin(), rows.end(), 0);
+        std::fill(columns.begin(), columns.end(), 0);
+    }
+
+    /// Same bits as plane, sized like it
+    void assign(const Bitplane& plane) {
+        if (dim != plane.Dim()) {
+            resize(plane.Dim());
+        } else {
+            clear();
+        }
+        plane.ForEach([&](int x, int y) { set(x, y); });
+    }
+
+    void set(int x, int y) {
+        rows[static_cast<size_t>(x) * lineWords + y / 64] |= uint64_t{1} << (y % 64);
+        columns[static_cast<size_t>(y) * lineWords + x / 64] |= uint64_t{1} << (x % 64);
+    }
+
+    bool test(int x, int y) const {
+        return (rows[static_cast<size_t>(x) * lineWords + y / 64] >> (y % 64)) & 1;
+    }
+
+    /// Tiles from (x, y) to the first set bit in direction dir, an index of
+    /// Position::DIRECTIONS, not counting (x, y) itself. std::nullopt if the
+    /// line has none up to the edge of the map.
+    std::optional<int> firstSet(int x, int y, int dir) const {
+        return scan<false>(x, y, dir);
+    }
+
+    /// Same as firstSet for the first unset bit
+    std::optional<int> firstClear(int x, int y, int dir) const {
+        return scan<true>(x, y, dir);
+    }
+
+private:
+    template<bool Inverted>
+    std::optional<int> scan(int x, int y, int dir) const {
+        // Up and down run along column y, right and left along row x
+        bool vertical = dir % 2 == 0;
+        const uint64_t* line = vertical ? &columns[static_cast<size_t>(y) * lineWords]
+                                        : &rows[static_cast<size_t>(x) * lineWords];
+        int from = vertical ? x : y;
+
+        if (dir == 1 || dir == 2) {
+            int start = from + 1;
+            for (int w = start / 64; w < lineWords; ++w) {
+                uint64_t word = Inverted ? ~line[w] : line[w];
+                if (w == start / 64) {
+                    word &= ~uint64_t{0} << (start % 64);
+                }
+                if (word != 0) {
+                    // Inverted padding past dim reads as set
+                    int bit = w * 64 + std::countr_zero(word);
+                    return bit < dim ? std::optional<int>(bit - from) : std::nullopt;
+                }
+            }
+        } else {
+            int start = from - 1;
+            for (int w = start / 64; start >= 0 && w >= 0; --w) {
+                uint64_t word = Inverted ? ~line[w] : line[w];
+                if (w == start / 64) {
+                    word &= ~uint64_t{0} >> (63 - start % 64);
+                }
+                if (word != 0) {
+                    return from - (w * 64 + 63 - std::countl_zero(word));
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    int dim = 0;
+    int lineWords = 0;
+    std::vector<uint64_t> rows;
+    std::vector<uint64_t> columns;
+};
+
+/// Line boards of the grid of one tick, for the bot's ray queries
+struct GridLines {
+    LineBoard visible;
+    /// Tanks of the other players by the axis they face, 0 for up and down, 1 for right and left
+    std::array<LineBoard, 2> enemies;
+    /// Bullets by the index of their direction
+    std::array<LineBoard, 4> bullets;
+
+    void update(const Grid& grid, PlayerId myId) {
+        visible.assign(grid.Layer(GridLayer::visible));
+        for (auto& board : enemies) {
+            board.resize(grid.dim);
+        }
+        for (const auto& [x, y, tank] : grid.tanks) {
+            if (tank.ownerId != myId) {
+                enemies[static_cast<int>(tank.direction) % 2].set(x, y);
+            }
+        }
+        for (auto& board : bullets) {
+            board.resize(grid.dim);
+        }
+        for (const auto& [x, y, bullet] : grid.bullets) {
+            bullets[static_cast<int>(bullet.direction)].set(x, y);
+        }
+    }
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "utils.h"
+
+#include <span>
+
+/// Actions are stored as their index in ALL_ACTIONS, which fits in 2 bits.
+/// Index of reversed(ALL_ACTIONS[action]).
+constexpr inline int reversedActionId(int action) {
+    return action ^ 1;
+}
+
+/// Same as afterMove(pos, ALL_ACTIONS[action]), without going through the variant
+inline OrientedPosition afterAction(OrientedPosition pos, int action) {
+    int dir = getDirId(pos.dir);
+    if (action >= 2) {
+        pos.dir = static_cast<Direction>((dir + (action == 2 ? 3 : 1)) % 4);
+        return pos;
+    }
+    auto [dx, dy] = Position::DIRECTIONS[action == 0 ? dir : (dir + 2) % 4];
+    pos.pos.x += dx;
+    pos.pos.y += dy;
+    return pos;
+}
+
+/// Memory of Bot::bfs, allocated once per match. States (x, y, dir) are
+/// flattened to (x * dim + y) * 4 + dir. A state is visited if its mark
+/// carries the generation of the current search, so starting a search only
+/// bumps the generation; the low 2 bits of the mark hold the reversed action
+/// that reached the state. Every state is queued at most once, so the queue
+/// is a flat array of dim² * 4 entries that never wraps.
+class SearchWorkspace {
+public:
+    struct Entry {
+        uint32_t state;
+        int timer;
+    };
+
+    void init(int dim) {
+        this->dim = dim;
+        size_t states = static_cast<size_t>(dim) * dim * 4;
+        marks.assign(states, 0);
+        queue.resize(states);
+        generation = 0;
+    }
+
+    /// Forgets the previous search
+    void begin() {
+        if (++generation > MAX_GENERATION) {
+            std::fill(marks.begin(), marks.end(), 0);
+            generation = 1;
+        }
+        head = 0;
+        tail = 0;
+    }
+
+    uint32_t state(const OrientedPosition& pos) const {
+        return (static_cast<uint32_t>(pos.pos.x) * dim + pos.pos.y) * 4 + getDirId(pos.dir);
+    }
+
+    OrientedPosition position(uint32_t state) const {
+        uint32_t cell = state / 4;
+        return OrientedPosition(Position(cell / dim, cell % dim), static_cast<Direction>(state % 4));
+    }
+
+    bool visited(uint32_t state) const {
+        return marks[state] >> 2 == generation;
+    }
+
+    /// Marks state visited, reached by undoing reversedAction
+    void visit(uint32_t state, int reversedAction) {
+        marks[state] = generation << 2 | static_cast<uint32_t>(reversedAction);
+    }
+
+    /// Reversed action stored by visit
+    int from(uint32_t state) const {
+        return marks[state] & 3;
+    }
+
+    void push(uint32_t state, int timer) {
+        queue[tail++] = Entry{state, timer};
+    }
+
+    bool empty() const {
+        return head == tail;
+    }
+
+    Entry pop() {
+        return queue[head++];
+    }
+
+    /// Every state queued by the current search, in search order
+    std::span<const Entry> reached() const {
+        return {queue.data(), tail};
+    }
+
+private:
+    static constexpr uint32_t MAX_GENERATION = (1u << 30) - 1;
+
+    int dim = 0;
+    uint32_t generation = 0;
+    std::vector<uint32_t> marks;
+    std::vector<Entry> queue;
+    size_t head = 0;
+    size_t tail = 0;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "search-workspace.h"
+#include "static-distances.h"
+
+/// Action id of waiting a tick, after the ALL_ACTIONS ids
+constexpr int WAIT_ACTION = 4;
+
+/// Plans a path over (x, y, dir, t) around the bullets and lasers the bot
+/// knows of. Once per tick update sweeps every tracked bullet forward at its
+/// speed, and reserves for each of the next HORIZON ticks the tiles a bullet
+/// passes during that tick and the tiles lasers hold. A state is safe if its
+/// tile is not reserved at its tick, so paths may wait or go through a
+/// firing line once the bullet has passed. From HORIZON on the map is static.
+/// Search is A* with the static distance to the goal as heuristic, Manhattan
+/// distance while StaticDistances is not ready.
+class SpaceTimePlanner {
+public:
+    static constexpr int HORIZON = 12;
+    /// Ticks a laser is assumed to keep its tiles
+    static constexpr int LASER_TICKS = 2;
+
+    void init(int dim) {
+        this->dim = dim;
+        size_t states = static_cast<size_t>(dim) * dim * 4 * (HORIZON + 1);
+        marks.assign(states, 0);
+        costs.assign(states, 0);
+        firstActions.assign(states, 0);
+        generation = 0;
+        reserved.assign(HORIZON + 1, Bitplane());
+        for (auto& tick : reserved) {
+            tick.Resize(dim);
+        }
+    }
+
+    /// Rebuilds the reservations from the knowledge of this tick
+    void update(const KnowledgeMap& knowledgeMap, const StaticMap& staticMap) {
+        for (auto& tick : reserved) {
+            tick.Resize(dim);
+        }
+        knowledgeMap.hazards.ForEach([&](int x, int y) {
+            for (const auto& known : knowledgeMap.tile(x, y)) {
+                if (std::holds_alternative<Bullet>(known.object)) {
+                    reserveBullet(Position(x, y), std::get<Bullet>(known.object), staticMap);
+                } else if (std::holds_alternative<Laser>(known.object)) {
+                    for (int t = 0; t <= LASER_TICKS; ++t) {
+                        reserved[t].Set(x, y);
+                    }
+                }
+            }
+        });
+    }
+
+    /// Tile reserved at tick t from now
+    bool isReserved(int x, int y, int t) const {
+        return t <= HORIZON && reserved[t].Test(x, y);
+    }
+
+    /// First action of a shortest safe path from start to goal, an ALL_ACTIONS
+    /// id or WAIT_ACTION, std::nullopt if none is found within maxExpansions.
+    /// Tiles blocked(x, y) accepts are never entered.
+    template<class Blocked>
+    std::optional<int> plan(const OrientedPosition& start, const Position& goal,
+                            const StaticDistances& distances, Blocked&& blocked, int maxExpansions) {
+        auto heuristic = [&](const OrientedPosition& pos) -> std::optional<int> {
+            if (distances.isReady()) {
+                return distances.eta(pos, goal);
+            }
+            return std::abs(pos.pos.x - goal.x) + std::abs(pos.pos.y - goal.y);
+        };
+
+        if (++generation > MAX_GENERATION) {
+            std::fill(marks.begin(), marks.end(), 0);
+            generation = 1;
+        }
+        open.clear();
+
+        auto startHeuristic = heuristic(start);
+        if (!startHeuristic) {
+            return std::nullopt;
+        }
+        uint32_t startState = state(start, 0);
+        marks[startState] = generation;
+        costs[startState] = 0;
+        pushOpen(Node{*startHeuristic, 0, startState});
+
+        for (int expansions = 0; !open.empty() && expansions < maxExpansions; ++expansions) {
+            std::pop_heap(open.begin(), open.end(), std::greater<>());
+            Node node = open.back();
+            open.pop_back();
+            if (node.cost != costs[node.state]) {
+                // Reached again more cheaply after it was queued
+                continue;
+            }
+
+            auto [pos, t] = position(node.state);
+            if (pos.pos == goal) {
+                return node.state == startState ? WAIT_ACTION : firstActions[node.state];
+            }
+
+            int nextT = std::min(t + 1, HORIZON);
+            for (int action = 0; action <= WAIT_ACTION; ++action) {
+                if (action == WAIT_ACTION && t == HORIZON) {
+                    // Waiting past the horizon changes nothing
+                    continue;
+                }
+                OrientedPosition nextPos = action == WAIT_ACTION ? pos : afterAction(pos, action);
+                if (!isValid(nextPos, dim) || blocked(nextPos.pos.x, nextPos.pos.y)
+                        || isReserved(nextPos.pos.x, nextPos.pos.y, nextT)) {
+                    continue;
+                }
+                auto nextHeuristic = heuristic(nextPos);
+                if (!nextHeuristic) {
+                    continue;
+                }
+
+                uint32_t next = state(nextPos, nextT);
+                int cost = node.cost + 1;
+                if (marks[next] == generation && costs[next] <= cost) {
+                    continue;
+                }
+                marks[next] = generation;
+                costs[next] = cost;
+                firstActions[next] = node.state == startState ? action : firstActions[node.state];
+                pushOpen(Node{cost + *nextHeuristic, cost, next});
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    static constexpr uint32_t MAX_GENERATION = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        int estimate;
+        int cost;
+        uint32_t state;
+        auto operator<=>(const Node&) const = default;
+    };
+
+    uint32_t state(const OrientedPosition& pos, int t) const {
+        return ((static_cast<uint32_t>(t) * dim + pos.pos.x) * dim + pos.pos.y) * 4 + getDirId(pos.dir);
+    }
+
+    std::pair<OrientedPosition, int> position(uint32_t state) const {
+        int dir = state % 4;
+        state /= 4;
+        int y = state % dim;
+        state /= dim;
+        int x = state % dim;
+        return {OrientedPosition(Position(x, y), static_cast<Direction>(dir)), static_cast<int>(state / dim)};
+    }
+
+    void pushOpen(const Node& node) {
+        open.push_back(node);
+        std::push_heap(open.begin(), open.end(), std::greater<>());
+    }
+
+    /// Reserves the tiles the bullet passes in each tick, including the one it leaves
+    void reserveBullet(Position pos, const Bullet& bullet, const StaticMap& staticMap) {
+        auto [dx, dy] = Position::DIRECTIONS[getDirId(bullet.direction)];
+        double speed = bullet.speed > 0 ? bullet.speed : 2;
+        reserved[0].Set(pos.x, pos.y);
+        int travelled = 0;
+        for (int t = 1; t < HORIZON; ++t) {
+            reserved[t].Set(pos.x, pos.y);
+            int until = static_cast<int>(std::ceil(speed * t));
+            for (; travelled < until; ++travelled) {
+                pos.x += dx;
+                pos.y += dy;
+                if (!isValid(pos, dim) || staticMap.IsWall(pos.x, pos.y)) {
+                    return;
+                }
+                reserved[t].Set(pos.x, pos.y);
+            }
+        }
+    }
+
+    int dim = 0;
+    uint32_t generation = 0;
+    /// Per tick from now, the last one stands for every later tick and stays empty
+    std::vector<Bitplane> reserved;
+    std::vector<uint32_t> marks;
+    std::vector<int> costs;
+    std::vector<uint8_t> firstActions;
+    std::vector<Node> open;
+};
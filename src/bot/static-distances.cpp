@@ -0,0 +1,71 @@
+#include "static-distances.h"
+
+StaticDistances::~StaticDistances() {
+    stop();
+}
+
+void StaticDistances::start(std::shared_ptr<const StaticMap> staticMap) {
+    stop();
+    this->staticMap = std::move(staticMap);
+    dim = this->staticMap->dim;
+    states = static_cast<size_t>(dim) * dim * 4;
+    if (static_cast<size_t>(dim) * dim * states > MAX_BYTES) {
+        return;
+    }
+    cancelled.store(false);
+    worker = std::thread(&StaticDistances::compute, this);
+}
+
+void StaticDistances::stop() {
+    cancelled.store(true);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    ready.store(false);
+}
+
+void StaticDistances::compute() {
+    const StaticMap& map = *staticMap;
+    search.init(dim);
+    table.assign(static_cast<size_t>(dim) * dim * states, FAR);
+
+    for (int x = 0; x < dim; ++x) {
+        for (int y = 0; y < dim; ++y) {
+            if (cancelled.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (map.IsWall(x, y)) {
+                continue;
+            }
+
+            // Every state reaching the tile is reached from it by the reversed actions
+            search.begin();
+            for (int dir = 0; dir < 4; ++dir) {
+                uint32_t state = search.state(OrientedPosition(Position(x, y), static_cast<Direction>(dir)));
+                search.visit(state, 0);
+                search.push(state, 0);
+            }
+
+            uint8_t* row = &table[static_cast<size_t>(x * dim + y) * states];
+            while (!search.empty()) {
+                auto [current, timer] = search.pop();
+                row[current] = static_cast<uint8_t>(std::min<int>(timer, FAR));
+
+                OrientedPosition pos = search.position(current);
+                for (int action = 0; action < 4; ++action) {
+                    auto nextPos = afterAction(pos, action);
+                    if (!isValid(nextPos, dim) || map.IsWall(nextPos.pos.x, nextPos.pos.y)) {
+                        continue;
+                    }
+                    uint32_t next = search.state(nextPos);
+                    if (!search.visited(next)) {
+                        search.visit(next, 0);
+                        search.push(next, timer + 1);
+                    }
+                }
+            }
+        }
+    }
+
+    ready.store(true, std::memory_order_release);
+}
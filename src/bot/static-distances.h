@@ -0,0 +1,61 @@
+#pragma once
+
+#include "search-workspace.h"
+
+#include <thread>
+
+/// Fewest actions from every (x, y, dir) state to every tile of a static map,
+/// with walls as the only obstacles, so a lower bound for the bot's searches
+/// that also avoid mines and bullets. Moves and rotations can be undone, so
+/// the distances to a tile come from one search started on its four states.
+/// The table is filled on a background thread once the walls of a match are
+/// known; until isReady() every query answers std::nullopt. One byte per
+/// entry, grids needing more than MAX_BYTES are not computed.
+class StaticDistances {
+public:
+    static constexpr size_t MAX_BYTES = size_t(64) << 20;
+    /// Stored for tiles out of reach or 255 and more actions away
+    static constexpr uint8_t FAR = 255;
+
+    StaticDistances() = default;
+    StaticDistances(const StaticDistances&) = delete;
+    StaticDistances& operator=(const StaticDistances&) = delete;
+    ~StaticDistances();
+
+    /// Starts computing the table of staticMap, dropping the previous one. Returns at once.
+    void start(std::shared_ptr<const StaticMap> staticMap);
+    /// Static map of the table being computed or ready
+    const StaticMap* source() const {
+        return staticMap.get();
+    }
+    bool isReady() const {
+        return ready.load(std::memory_order_acquire);
+    }
+
+    /// Actions from pos to tile, facing any direction there
+    std::optional<int> eta(const OrientedPosition& pos, const Position& tile) const {
+        if (!isReady()) {
+            return std::nullopt;
+        }
+        uint8_t distance = table[static_cast<size_t>(tile.x * dim + tile.y) * states + search.state(pos)];
+        if (distance == FAR) {
+            return std::nullopt;
+        }
+        return distance;
+    }
+
+private:
+    void stop();
+    void compute();
+
+    std::shared_ptr<const StaticMap> staticMap;
+    int dim = 0;
+    size_t states = 0;
+    /// Row of every tile, entry of every state
+    std::vector<uint8_t> table;
+    /// Used by compute, afterwards only to index states
+    SearchWorkspace search;
+    std::thread worker;
+    std::atomic<bool> ready{false};
+    std::atomic<bool> cancelled{false};
+};
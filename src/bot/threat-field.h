@@ -0,0 +1,88 @@
+#pragma once
+
+#include "utils.h"
+#include "tick-field.h"
+
+/// Fewest ticks before any known enemy tank can have a bullet on each tile:
+/// the turret rotations to face the tile plus the flight of a bullet at
+/// BULLET_SPEED, for tiles in a clear line from the tank. The free run of
+/// every tile in every direction is computed once per static map, so an
+/// update walks at most four rays per enemy. Visible and remembered tanks
+/// are taken where they were last seen.
+class ThreatField : public TickField {
+public:
+    static constexpr int BULLET_SPEED = 2;
+
+    void init(int dim) {
+        TickField::init(dim);
+        source = nullptr;
+    }
+
+    /// Rebuilds the field from the tanks knowledgeMap holds
+    void update(const KnowledgeMap& knowledgeMap, const StaticMap& staticMap, PlayerId myId) {
+        if (source != &staticMap) {
+            source = &staticMap;
+            computeRays(staticMap);
+        }
+        clear();
+
+        knowledgeMap.known.ForEach([&](int x, int y) {
+            for (const auto& known : knowledgeMap.tile(x, y)) {
+                if (std::holds_alternative<Tank>(known.object)) {
+                    const auto& tank = std::get<Tank>(known.object);
+                    if (tank.ownerId != myId) {
+                        addTank(x, y, tank);
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    /// Free run of every tile, tiles before the first wall or the edge
+    void computeRays(const StaticMap& staticMap) {
+        rays.assign(static_cast<size_t>(dim) * dim * 4, 0);
+        // Each direction is filled from the side it points to
+        for (int x = 0; x < dim; ++x) {
+            for (int y = 0; y < dim; ++y) {
+                if (x > 0 && !staticMap.IsWall(x - 1, y)) {
+                    ray(x, y, 0) = ray(x - 1, y, 0) + 1;
+                }
+                if (y > 0 && !staticMap.IsWall(x, y - 1)) {
+                    ray(x, y, 3) = ray(x, y - 1, 3) + 1;
+                }
+            }
+        }
+        for (int x = dim - 1; x >= 0; --x) {
+            for (int y = dim - 1; y >= 0; --y) {
+                if (x + 1 < dim && !staticMap.IsWall(x + 1, y)) {
+                    ray(x, y, 2) = ray(x + 1, y, 2) + 1;
+                }
+                if (y + 1 < dim && !staticMap.IsWall(x, y + 1)) {
+                    ray(x, y, 1) = ray(x, y + 1, 1) + 1;
+                }
+            }
+        }
+    }
+
+    void addTank(int x, int y, const Tank& tank) {
+        int turret = getDirId(tank.turret.direction);
+        for (int dir = 0; dir < 4; ++dir) {
+            // A quarter turn per tick, two to face backwards
+            int rotations = dir == turret ? 0 : (dir + 2) % 4 == turret ? 2 : 1;
+            auto [dx, dy] = Position::DIRECTIONS[dir];
+            int length = ray(x, y, dir);
+            for (int distance = 1; distance <= length; ++distance) {
+                mark(x + dx * distance, y + dy * distance,
+                     rotations + (distance + BULLET_SPEED - 1) / BULLET_SPEED);
+            }
+        }
+    }
+
+    uint16_t& ray(int x, int y, int dir) {
+        return rays[(static_cast<size_t>(x) * dim + y) * 4 + dir];
+    }
+
+    const StaticMap* source = nullptr;
+    std::vector<uint16_t> rays;
+};
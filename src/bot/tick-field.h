@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../pch.h"
+
+/// Earliest tick from now at which something reaches each tile. One byte per
+/// tile; clear only resets the tiles marked since the previous clear.
+class TickField {
+public:
+    /// Earliest tick of tiles nothing reaches
+    static constexpr uint8_t SAFE = 255;
+
+    void init(int dim) {
+        this->dim = dim;
+        ticks.assign(static_cast<size_t>(dim) * dim, SAFE);
+        marked.clear();
+    }
+
+    void clear() {
+        for (size_t cell : marked) {
+            ticks[cell] = SAFE;
+        }
+        marked.clear();
+    }
+
+    /// Tile (x, y) is reached from tick on, if not earlier
+    void mark(int x, int y, int tick) {
+        size_t cell = static_cast<size_t>(x) * dim + y;
+        uint8_t value = static_cast<uint8_t>(std::min(tick, SAFE - 1));
+        if (ticks[cell] == SAFE) {
+            marked.push_back(cell);
+        }
+        ticks[cell] = std::min(ticks[cell], value);
+    }
+
+    /// Earliest tick at which (x, y) is reached, SAFE if nothing known reaches it
+    int earliest(int x, int y) const {
+        return ticks[static_cast<size_t>(x) * dim + y];
+    }
+
+    /// Tile (x, y) is reached within numTicks ticks
+    bool isReachedWithin(int x, int y, int numTicks) const {
+        return earliest(x, y) <= numTicks;
+    }
+
+protected:
+    int dim = 0;
+
+private:
+    std::vector<uint8_t> ticks;
+    std::vector<size_t> marked;
+};
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <set>
+#include <deque>
 
 #include "../processed-packets.h"
+#include "danger-map.h"
 
 constexpr inline int getDirId(const Direction& dir) {
     return static_cast<std::underlying_type<Direction>::type>(dir);
@@ -137,197 +138,424 @@ constexpr inline bool isParallel(const Direction& dir1, const Direction& dir2) {
     return id1 == id2 || id1 == (id2 + 2) % 4;
 }
 
+/// What happened to an object of the grid since the previous tick
+enum class EntityEvent {
+    appeared,
+    moved,
+    changed,
+    disappeared
+};
+
+struct EntityChange {
+    EntityEvent event;
+    GridLayer layer;
+    /// Owner of a tank, id of a bullet, laser or mine, -1 for items
+    int id;
+    /// Tile in the previous tick, unused for appeared
+    Position from;
+    /// Tile in this tick, unused for disappeared
+    Position to;
+};
+
+/// Difference between the grids of two consecutive ticks: the tiles whose
+/// objects or visibility changed and the objects that appeared, moved, changed
+/// or disappeared. Keeps a copy of the previous grid, whose GameState is gone
+/// by the next tick. Objects are matched by owner or id, items by tile and type.
+class TickDelta {
+public:
+    /// Forgets the previous grid, the next update reports everything on the grid
+    void init(int dim) {
+        previous = Grid();
+        previous.Resize(dim);
+        previousVisible.Resize(dim);
+        changed.Resize(dim);
+    }
+
+    /// Diffs grid against the one of the previous call
+    void update(const Grid& grid) {
+        if (previous.dim != grid.dim) {
+            init(grid.dim);
+        }
+        cells.clear();
+        changes.clear();
+        changed.Resize(grid.dim);
+
+        for (int layer = static_cast<int>(GridLayer::tank); layer < static_cast<int>(GridLayer::count); ++layer) {
+            changed.SetDifferences(previous.Layer(GridLayer(layer)), grid.Layer(GridLayer(layer)));
+        }
+        diff<Tank>(grid);
+        diff<Bullet>(grid);
+        diff<Laser>(grid);
+        diff<Mine>(grid);
+        diff<Item>(grid);
+        changed.ForEach([&](int x, int y) {
+            cells.emplace_back(x, y);
+        });
+
+        previousVisible = previous.Layer(GridLayer::visible);
+        previous = grid;
+    }
+
+    /// Tiles whose objects or visibility changed, in row-major order
+    const std::vector<Position>& changedCells() const {
+        return cells;
+    }
+
+    const std::vector<EntityChange>& entities() const {
+        return changes;
+    }
+
+    bool isChanged(int x, int y) const {
+        return changed.Test(x, y);
+    }
+
+    /// Visibility in the previous tick
+    bool wasVisible(int x, int y) const {
+        return previousVisible.Test(x, y);
+    }
+
+private:
+    template <typename T>
+    static int entityId(const T& object) {
+        if constexpr (std::is_same_v<T, Tank>) {
+            return object.ownerId;
+        } else if constexpr (std::is_same_v<T, Item>) {
+            return -1;
+        } else {
+            return object.id;
+        }
+    }
+
+    template <typename T>
+    static bool sameEntity(const GridObject<T>& lhs, const GridObject<T>& rhs) {
+        if constexpr (std::is_same_v<T, Item>) {
+            return lhs.x == rhs.x && lhs.y == rhs.y && lhs.object.type == rhs.object.type;
+        } else {
+            return entityId(lhs.object) == entityId(rhs.object);
+        }
+    }
+
+    template <typename T>
+    static const GridObject<T>* findEntity(const std::pmr::vector<GridObject<T>>& objects, const GridObject<T>& entity) {
+        for (const auto& object : objects) {
+            if (sameEntity(object, entity)) {
+                return &object;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Objects of a tick are few, so they are matched pairwise
+    template <typename T>
+    void diff(const Grid& grid) {
+        const auto& before = previous.Objects<T>();
+        const auto& after = grid.Objects<T>();
+        GridLayer layer = Grid::LayerOf<T>();
+
+        for (const auto& old : before) {
+            const GridObject<T>* now = findEntity(after, old);
+            Position from(old.x, old.y);
+            if (now == nullptr) {
+                changes.push_back({EntityEvent::disappeared, layer, entityId(old.object), from, from});
+                changed.Set(old.x, old.y);
+            } else if (now->x != old.x || now->y != old.y) {
+                changes.push_back({EntityEvent::moved, layer, entityId(old.object), from, Position(now->x, now->y)});
+                changed.Set(old.x, old.y);
+                changed.Set(now->x, now->y);
+            } else if (!(now->object == old.object)) {
+                changes.push_back({EntityEvent::changed, layer, entityId(old.object), from, from});
+                changed.Set(old.x, old.y);
+            }
+        }
+        for (const auto& now : after) {
+            if (findEntity(before, now) == nullptr) {
+                Position to(now.x, now.y);
+                changes.push_back({EntityEvent::appeared, layer, entityId(now.object), to, to});
+                changed.Set(now.x, now.y);
+            }
+        }
+    }
+
+    Grid previous;
+    Bitplane previousVisible;
+    Bitplane changed;
+    std::vector<Position> cells;
+    std::vector<EntityChange> changes;
+};
+
 struct KnowledgeTileVariant {
     int lastSeen;
     TileVariant object;
     auto operator<=>(const KnowledgeTileVariant&) const = default;
 };
 
-struct KnowledgeTileVariantComparator {
-    bool operator()(const KnowledgeTileVariant& lhs, const KnowledgeTileVariant& rhs) const {
-        return lhs.lastSeen < rhs.lastSeen;
+/// Objects remembered on one tile, up to CAPACITY of them stored in place.
+/// Objects seen in the same tick are all kept; on a full tile the one seen
+/// longest ago makes room for a new one.
+class KnowledgeTile {
+public:
+    static constexpr int CAPACITY = 4;
+
+    KnowledgeTileVariant* begin() { return slots.data(); }
+    KnowledgeTileVariant* end() { return slots.data() + count; }
+    const KnowledgeTileVariant* begin() const { return slots.data(); }
+    const KnowledgeTileVariant* end() const { return slots.data() + count; }
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+
+    void clear() {
+        count = 0;
+    }
+
+    void insert(const KnowledgeTileVariant& known) {
+        if (count == CAPACITY) {
+            erase(std::min_element(begin(), end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.lastSeen < rhs.lastSeen;
+            }));
+        }
+        slots[count++] = known;
+    }
+
+    /// Removes the object keeping the order of the others, returns the one after it
+    KnowledgeTileVariant* erase(KnowledgeTileVariant* it) {
+        std::move(it + 1, end(), it);
+        --count;
+        return it;
     }
-};
 
-struct KnowledgeTile {
-    std::set<KnowledgeTileVariant, KnowledgeTileVariantComparator> objects;
-    auto operator<=>(const KnowledgeTile&) const = default;
+private:
+    std::array<KnowledgeTileVariant, CAPACITY> slots;
+    int count = 0;
 };
 
 struct KnowledgeMap {
     static constexpr int MAX_TRACK_TIME = 10;
     static constexpr int MINE_TRACK_TIME = 100;
 
-    std::vector<std::vector<KnowledgeTile>> tiles;
-    std::vector<std::vector<int>> minesLiveness;
+    int dim = 0;
+    /// Row-major, see tile
+    std::vector<KnowledgeTile> tiles;
+    /// Tick of the last update, ticks answered without one are made up for by the next
+    int time = 0;
+    /// Row-major, a tile holds a mine while its deadline is after time
+    std::vector<int> mineDeadlines;
+    /// Out-of-sight tiles in the order they were restamped, with the tick their objects expire
+    std::deque<std::pair<int, Position>> expiries;
+    /// Tiles whose objects the current update changed, see reindex
+    std::vector<Position> touched;
+    /// Tiles whose knowledge holds a bullet or a laser
+    Bitplane hazards;
+    /// Tiles whose knowledge holds an exploding mine
+    Bitplane explosions;
+    /// Tiles with any knowledge, a superset: emptied tiles are dropped at the end of update
+    Bitplane known;
+    /// Visible tiles whose knowledge is rebuilt by the current update
+    Bitplane refreshed;
+    /// Walls of the static map update last saw
+    LineBoard walls;
+    const StaticMap* wallsSource = nullptr;
+    /// When the remembered bullets, lasers and exploding mines make each tile lethal
+    DangerMap danger;
+
+    KnowledgeTile& tile(int x, int y) {
+        return tiles[static_cast<size_t>(x) * dim + y];
+    }
+    const KnowledgeTile& tile(int x, int y) const {
+        return tiles[static_cast<size_t>(x) * dim + y];
+    }
 
     void init(int dim) {
-        tiles = std::vector<std::vector<KnowledgeTile>>(dim, std::vector<KnowledgeTile>(dim));
-        minesLiveness = std::vector<std::vector<int>>(dim, std::vector<int>(dim, 0));
+        this->dim = dim;
+        tiles.assign(static_cast<size_t>(dim) * dim, KnowledgeTile());
+        time = 0;
+        mineDeadlines.assign(static_cast<size_t>(dim) * dim, 0);
+        expiries.clear();
+        touched.clear();
+        hazards.Resize(dim);
+        explosions.Resize(dim);
+        known.Resize(dim);
+        refreshed.Resize(dim);
+        walls.resize(dim);
+        wallsSource = nullptr;
+        danger.init(dim);
     }
 
-    bool isOnBulletTraj(int x, int y, int numTicks = 10) const {
-        for (int i = 0; i < 4; i++) {
-            auto [dx, dy] = Position::DIRECTIONS[i];
-            for (int j = 1; j < 2 * numTicks; j++) {
-                int nx = x + j * dx;
-                int ny = y + j * dy;
-                if (!isValid(Position(nx, ny), tiles.size())) {
-                    break;
-                }
-                for (const auto& obj : tiles[x][y].objects) {
-                    if (std::holds_alternative<Bullet>(obj.object)) {
-                        const auto& bullet = std::get<Bullet>(obj.object);
-                        if (bullet.direction == Direction::down && i == 0) {
-                            return true;
-                        }
-                        if (bullet.direction == Direction::up && i == 2) {
-                            return true;
-                        }
-                        if (bullet.direction == Direction::right && i == 3) {
-                            return true;
-                        }
-                        if (bullet.direction == Direction::left && i == 1) {
-                            return true;
-                        }
-                    }
-                    else if (std::holds_alternative<Laser>(obj.object)) {
-                        return true;
-                    }
-                }
+    void notifyMine(const GameState& gameState, const Position& pos) {
+        mineDeadlines[static_cast<size_t>(pos.x) * dim + pos.y] = gameState.time + MINE_TRACK_TIME;
+    }
+
+    bool containsMine(const Position& pos) const {
+        return mineDeadlines[static_cast<size_t>(pos.x) * dim + pos.y] > time;
+    }
+
+    template <typename T>
+    void remember(const GameState& gameState, const std::pmr::vector<GridObject<T>>& objects) {
+        for (const auto& [x, y, object] : objects) {
+            if (!gameState.map.grid.IsVisible(x, y)) {
+                continue;
+            }
+            if constexpr (std::is_same_v<T, Mine>) {
+                notifyMine(gameState, Position(x, y));
+            }
+            // Unchanged tiles still hold what was remembered on them
+            if (!refreshed.Test(x, y)) {
+                continue;
             }
+            tile(x, y).insert({gameState.time, object});
+            known.Set(x, y);
         }
-        return false;
     }
 
-    bool willBeHitByBulletInNextMove(int x, int y) const {
-        return isOnBulletTraj(x, y, 1);
+    /// Stamps everything on a tile that just went out of sight with the last tick it was seen
+    void restamp(int x, int y, int lastSeen) {
+        for (auto& object : tile(x, y)) {
+            object.lastSeen = lastSeen;
+        }
+        expiries.emplace_back(lastSeen + MAX_TRACK_TIME + 1, Position(x, y));
     }
 
-    void notifyMine(const GameState& gameState, const Position& pos) {
-        minesLiveness[pos.x][pos.y] = MINE_TRACK_TIME;
+    /// Recomputes the planes of a tile whose objects changed
+    void reindex(int x, int y) {
+        known.Clear(x, y);
+        hazards.Clear(x, y);
+        explosions.Clear(x, y);
+        for (const auto& obj : tile(x, y)) {
+            known.Set(x, y);
+            if (std::holds_alternative<Bullet>(obj.object) || std::holds_alternative<Laser>(obj.object)) {
+                hazards.Set(x, y);
+            } else if (std::holds_alternative<Mine>(obj.object)
+                    && std::get<Mine>(obj.object).explosionRemainingTicks.has_value()) {
+                explosions.Set(x, y);
+            }
+        }
     }
 
-    bool containsMine(const Position& pos) {
-        return minesLiveness[pos.x][pos.y] > 0;
-    }
+    /// Brings the knowledge up to gameState using the changes since the previous
+    /// update. A visible tile holds what is seen on it and is only rebuilt when
+    /// delta reports it changed. A tile going out of sight is queued with the
+    /// tick its objects expire and looked at again only then, remembered
+    /// bullets are found through the hazards plane and mines expire by
+    /// deadline, so the work follows the changes and the remembered objects.
+    void update(const GameState& gameState, const TickDelta& delta) {
+        const Grid& grid = gameState.map.grid;
+        std::pmr::vector<std::pair<Bullet, Position>> bullets(gameState.Resource());
+        refreshed.Resize(dim);
+        touched.clear();
+        // Remembered bullets fly on through the ticks the bot answered without an update
+        int elapsed = std::max(1, gameState.time - time);
+        time = gameState.time;
+
+        if (gameState.map.staticMap && gameState.map.staticMap.get() != wallsSource) {
+            wallsSource = gameState.map.staticMap.get();
+            walls.assign(wallsSource->walls);
+        }
 
-    void update(const GameState& gameState) {
-        std::vector<std::pair<Bullet, Position>> bullets;
+        for (const Position& pos : delta.changedCells()) {
+            if (grid.IsVisible(pos.x, pos.y)) {
+                // Refilled from the grid's side tables below
+                tile(pos.x, pos.y).clear();
+                refreshed.Set(pos.x, pos.y);
+                touched.push_back(pos);
+            } else if (delta.wasVisible(pos.x, pos.y)) {
+                restamp(pos.x, pos.y, gameState.time - 1);
+            }
+        }
 
-        for (int i = 0; i < gameState.map.tiles.size(); ++i) {
-            for (int j = 0; j < gameState.map.tiles[i].size(); ++j) {
-                if (gameState.map.tiles[i][j].isVisible) {
-                    tiles[i][j].objects.clear();
-                    for (const TileVariant& object : gameState.map.tiles[i][j].objects) {
-                        if (std::holds_alternative<Mine>(object)) {
-                            notifyMine(gameState, Position(i, j));
-                        }
-                        if (!std::holds_alternative<Wall>(object)) {
-                            tiles[i][j].objects.insert({gameState.time, object});
-                        }
-                    }
-                }
-                else {
-                    for (auto it = tiles[i][j].objects.begin(); it != tiles[i][j].objects.end();) {
-                        if (std::holds_alternative<Bullet>(it->object)) {
-                            bullets.emplace_back(std::get<Bullet>(it->object), Position(i, j));
-                            it = tiles[i][j].objects.erase(it);
-                        } else if (gameState.time - it->lastSeen > MAX_TRACK_TIME) {
-                            it = tiles[i][j].objects.erase(it);
-                        } else {
-                            ++it;
-                        }
-                    }
+        // Restamped in tick order, so the deadlines come in order too
+        while (!expiries.empty() && expiries.front().first <= gameState.time) {
+            auto [x, y] = expiries.front().second;
+            expiries.pop_front();
+            if (grid.IsVisible(x, y)) {
+                continue;
+            }
+            auto& objects = tile(x, y);
+            for (auto it = objects.begin(); it != objects.end();) {
+                // Bullets move on below instead
+                if (!std::holds_alternative<Bullet>(it->object) && gameState.time - it->lastSeen > MAX_TRACK_TIME) {
+                    it = objects.erase(it);
+                } else {
+                    ++it;
                 }
             }
+            touched.emplace_back(x, y);
         }
 
+        hazards.ForEach([&](int i, int j) {
+            if (grid.IsVisible(i, j)) {
+                return;
+            }
+            auto& objects = tile(i, j);
+            for (auto it = objects.begin(); it != objects.end();) {
+                if (std::holds_alternative<Bullet>(it->object)) {
+                    bullets.emplace_back(std::get<Bullet>(it->object), Position(i, j));
+                    it = objects.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            touched.emplace_back(i, j);
+        });
+
+        remember(gameState, grid.tanks);
+        remember(gameState, grid.bullets);
+        remember(gameState, grid.mines);
+        remember(gameState, grid.lasers);
+        remember(gameState, grid.items);
+
         for (auto [bullet, pos] : bullets) {
             auto [dx, dy] = Position::DIRECTIONS[getDirId(bullet.direction)];
-            for (int i = 0; i < 2; i++) {
+            // Two tiles a tick, remembered on the two it crossed in the last one
+            for (int i = 0; i < 2 * elapsed; i++) {
                 pos.x += dx;
                 pos.y += dy;
-                if (!isValid(pos, tiles.size())) {
+                if (!isValid(pos, dim) || walls.test(pos.x, pos.y)) {
                     break;
                 }
-                tiles[pos.x][pos.y].objects.insert({gameState.time, bullet});
+                if (i < 2 * (elapsed - 1)) {
+                    continue;
+                }
+                if (grid.IsVisible(pos.x, pos.y)) {
+                    // A visible tile holds what is seen on it, a bullet there is already on the grid
+                    continue;
+                }
+                tile(pos.x, pos.y).insert({gameState.time, bullet});
+                touched.push_back(pos);
             }
         }
 
-        for (int i = 0; i < minesLiveness.size(); ++i) {
-            for (int j = 0; j < minesLiveness[i].size(); ++j) {
-                if (minesLiveness[i][j] > 0) {
-                    --minesLiveness[i][j];
+        for (const Position& pos : touched) {
+            reindex(pos.x, pos.y);
+        }
+
+        danger.clear();
+        hazards.ForEach([&](int i, int j) {
+            for (const auto& obj : tile(i, j)) {
+                if (std::holds_alternative<Bullet>(obj.object)) {
+                    const auto& bullet = std::get<Bullet>(obj.object);
+                    danger.addBullet(i, j, getDirId(bullet.direction), bullet.speed, walls);
+                } else if (std::holds_alternative<Laser>(obj.object)) {
+                    danger.mark(i, j, 0);
                 }
             }
-        }
+        });
+        explosions.ForEach([&](int i, int j) {
+            danger.mark(i, j, 0);
+        });
     }
 };
 
-inline Position closestBullet(const GameState& gameState, const Position& myPos) {
+/// Closest bullet of the grid flying along myPos's row or column towards it, Position(1e9, 1e9) if none
+inline Position closestBullet(const GridLines& lines, const Position& myPos) {
     Position closestBulletPos = Position(1e9, 1e9);
-    double closestBulletDist = 1e9;
-
-    // Position result = Position(1e9, 1e9);
-    for (int i = 0; i < myPos.x; i++) {
-        if (gameState.map.tiles[i][myPos.y].objects.size() > 0) {
-            for (const auto& obj : gameState.map.tiles[i][myPos.y].objects) {
-                if (std::holds_alternative<Bullet>(obj)) {
-                    const auto& bullet = std::get<Bullet>(obj);
-                    if (bullet.direction == Direction::down) {
-                        if (myPos.x - i < closestBulletDist) {
-                            closestBulletDist = myPos.x - i;
-                            closestBulletPos = Position(i, myPos.y);
-                        }
-                    }
-                }
-            }
-        }
-    }
-    for (int i = myPos.x + 1; i < gameState.map.tiles.size(); i++) {
-        if (gameState.map.tiles[i][myPos.y].objects.size() > 0) {
-            for (const auto& obj : gameState.map.tiles[i][myPos.y].objects) {
-                if (std::holds_alternative<Bullet>(obj)) {
-                    const auto& bullet = std::get<Bullet>(obj);
-                    if (bullet.direction == Direction::up) {
-                        if (i - myPos.x < closestBulletDist) {
-                            closestBulletDist = i - myPos.x;
-                            closestBulletPos = Position(i, myPos.y);
-                        }
-                    }
-                }
-            }
-        }
-    }
-    for (int i = 0; i < myPos.y; i++) {
-        if (gameState.map.tiles[myPos.x][i].objects.size() > 0) {
-            for (const auto& obj : gameState.map.tiles[myPos.x][i].objects) {
-                if (std::holds_alternative<Bullet>(obj)) {
-                    const auto& bullet = std::get<Bullet>(obj);
-                    if (bullet.direction == Direction::right) {
-                        if (myPos.y - i < closestBulletDist) {
-                            closestBulletDist = myPos.y - i;
-                            closestBulletPos = Position(myPos.x, i);
-                        }
-                    }
-                }
-            }
-        }
-    }
-    for (int i = myPos.y + 1; i < gameState.map.tiles[0].size(); i++) {
-        if (gameState.map.tiles[myPos.x][i].objects.size() > 0) {
-            for (const auto& obj : gameState.map.tiles[myPos.x][i].objects) {
-                if (std::holds_alternative<Bullet>(obj)) {
-                    const auto& bullet = std::get<Bullet>(obj);
-                    if (bullet.direction == Direction::left) {
-                        if (i - myPos.y < closestBulletDist) {
-                            closestBulletDist = i - myPos.y;
-                            closestBulletPos = Position(myPos.x, i);
-                        }
-                    }
-                }
-            }
+    int closestBulletDist = 1e9;
+
+    // Ties go to the bullet above, then below, left and right
+    for (int dir : {0, 2, 3, 1}) {
+        auto distance = lines.bullets[(dir + 2) % 4].firstSet(myPos.x, myPos.y, dir);
+        if (distance && *distance < closestBulletDist) {
+            auto [dx, dy] = Position::DIRECTIONS[dir];
+            closestBulletDist = *distance;
+            closestBulletPos = Position(myPos.x + dx * *distance, myPos.y + dy * *distance);
         }
     }
 
@@ -361,39 +589,39 @@ inline bool isZoneFree(const Zone &zone)
     return zone.status.type == "neutral";
 }
 
-inline bool isZoneCapturedByPlayer(const Zone &zone, const std::string &playerId)
+inline bool isZoneCapturedByPlayer(const Zone &zone, PlayerId playerId)
 {
     return zone.status.type == "captured" &&
            zone.status.playerId == playerId;
 }
 
-inline std::function<bool(const OrientedPosition &, int timer)> targetZone(char zoneNameToTarget, const std::vector<std::vector<char>> &zoneName)
+inline std::function<bool(const OrientedPosition &, int timer)> targetZone(char zoneNameToTarget, const StaticMap &staticMap)
 {
     std::cout<<zoneNameToTarget<<std::endl;
     return [&](const OrientedPosition &oPos, int timer)
     {
-        return zoneName[oPos.pos.x][oPos.pos.y] == zoneNameToTarget;
+        return staticMap.ZoneName(oPos.pos.x, oPos.pos.y) == zoneNameToTarget;
     };
 }
 
-inline std::function<bool(const OrientedPosition &, int timer)> targetAnyZone(const std::vector<std::vector<char>> &zoneName)
+inline std::function<bool(const OrientedPosition &, int timer)> targetAnyZone(const StaticMap &staticMap)
 {
     return [&](const OrientedPosition &oPos, int timer)
     {
-        return zoneName[oPos.pos.x][oPos.pos.y] != '?';
+        return staticMap.ZoneName(oPos.pos.x, oPos.pos.y) != '?';
     };
 }
 
-inline bool isBetweenWalls(Position myPos, const std::vector<std::vector<bool>>& isWall, int dim) {
+inline bool isBetweenWalls(Position myPos, const Bitplane& walls, int dim) {
     int x = myPos.x;
     int y = myPos.y;
     
-    if ((!isValid(Position(x - 1, y), dim) || isWall[x - 1][y])
-        && (!isValid(Position(x + 1, y), dim) || isWall[x + 1][y])) {
+    if ((!isValid(Position(x - 1, y), dim) || walls.Test(x - 1, y))
+        && (!isValid(Position(x + 1, y), dim) || walls.Test(x + 1, y))) {
         return true;
     }
-    if ((!isValid(Position(x, y - 1), dim) || isWall[x][y - 1])
-        && (!isValid(Position(x, y + 1), dim) || isWall[x][y + 1])) {
+    if ((!isValid(Position(x, y - 1), dim) || walls.Test(x, y - 1))
+        && (!isValid(Position(x, y + 1), dim) || walls.Test(x, y + 1))) {
         return true;
     }
     return false;
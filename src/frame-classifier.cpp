@@ -0,0 +1,63 @@
+#include "frame-classifier.h"
+
+namespace {
+
+// Advances past the string starting at frame[i] == '"', returns index after the closing quote
+size_t SkipString(std::string_view frame, size_t i) {
+    for (++i; i < frame.size(); ++i) {
+        if (frame[i] == '\\') {
+            ++i;
+        } else if (frame[i] == '"') {
+            return i + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+}
+
+std::optional<PacketType> PeekPacketType(std::string_view frame) {
+    static constexpr std::string_view typeKey = "\"type\"";
+
+    int depth = 0;
+    bool expectKey = false;
+    size_t i = 0;
+    while (i < frame.size()) {
+        char c = frame[i];
+        if (c == '"') {
+            size_t end = SkipString(frame, i);
+            if (end == std::string_view::npos) return std::nullopt;
+
+            if (depth == 1 && expectKey && frame.substr(i, end - i) == typeKey) {
+                i = end;
+                while (i < frame.size() && (frame[i] == ' ' || frame[i] == ':' || frame[i] == '\t'
+                                            || frame[i] == '\n' || frame[i] == '\r')) {
+                    ++i;
+                }
+                uint64_t value = 0;
+                size_t digits = 0;
+                for (; i < frame.size() && frame[i] >= '0' && frame[i] <= '9'; ++i, ++digits) {
+                    value = value * 10 + (frame[i] - '0');
+                }
+                if (digits == 0) return std::nullopt;
+                return static_cast<PacketType>(value);
+            }
+            expectKey = false;
+            i = end;
+            continue;
+        }
+
+        if (c == '{') {
+            ++depth;
+            expectKey = true;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            --depth;
+        } else if (c == ',') {
+            expectKey = true;
+        }
+        ++i;
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "pch.h"
+#include "packet.h"
+
+/// Reads the top-level "type" field of a raw frame without building a JSON DOM.
+/// Nested objects (tiles, zone statuses) also carry "type" keys, so only keys
+/// at depth one are considered. Returns std::nullopt if the frame is malformed
+/// or has no numeric top-level type.
+std::optional<PacketType> PeekPacketType(std::string_view frame);
@@ -0,0 +1,358 @@
+#include "game-state-decoder.h"
+
+namespace {
+
+std::optional<int> ReadNullableInt(JsonReader& reader) {
+	if (reader.ReadNull()) return std::nullopt;
+	return static_cast<int>(reader.ReadInt());
+}
+
+std::optional<PlayerId> ReadNullablePlayer(JsonReader& reader, PlayerRegistry& players) {
+	if (reader.ReadNull()) return std::nullopt;
+	return players.Intern(reader.ReadString());
+}
+
+void DecodePlayer(JsonReader& reader, Player& player, PlayerRegistry& players) {
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		switch (KeyHash(key)) {
+			case KeyHash("id"): player.id = players.Intern(reader.ReadString()); break;
+			case KeyHash("nickname"): player.nickname = reader.ReadString(); break;
+			case KeyHash("color"): player.color = static_cast<uint32_t>(reader.ReadInt()); break;
+			case KeyHash("ping"): player.ping = static_cast<int>(reader.ReadInt()); break;
+			case KeyHash("score"): player.score = ReadNullableInt(reader); break;
+			case KeyHash("ticksToRegen"): player.ticksToRegen = ReadNullableInt(reader); break;
+			case KeyHash("isUsingRadar"):
+				if (!reader.ReadNull()) player.isUsingRadar = reader.ReadBool();
+				break;
+			default: reader.Skip(); break;
+		}
+	}
+}
+
+void DecodeZoneStatus(JsonReader& reader, ZoneStatus& status, PlayerRegistry& players) {
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		switch (KeyHash(key)) {
+			case KeyHash("type"): status.type = reader.ReadString(); break;
+			case KeyHash("remainingTicks"): status.remainingTicks = ReadNullableInt(reader); break;
+			case KeyHash("playerId"): status.playerId = ReadNullablePlayer(reader, players); break;
+			case KeyHash("capturedById"): status.capturedById = ReadNullablePlayer(reader, players); break;
+			case KeyHash("retakenById"): status.retakenById = ReadNullablePlayer(reader, players); break;
+			default: reader.Skip(); break;
+		}
+	}
+}
+
+void DecodeZone(JsonReader& reader, Zone& zone, PlayerRegistry& players) {
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		switch (KeyHash(key)) {
+			case KeyHash("x"): zone.x = static_cast<int>(reader.ReadInt()); break;
+			case KeyHash("y"): zone.y = static_cast<int>(reader.ReadInt()); break;
+			case KeyHash("width"): zone.width = static_cast<int>(reader.ReadInt()); break;
+			case KeyHash("height"): zone.height = static_cast<int>(reader.ReadInt()); break;
+			case KeyHash("index"): zone.name = static_cast<char>(reader.ReadInt()); break;
+			case KeyHash("status"): DecodeZoneStatus(reader, zone.status, players); break;
+			default: reader.Skip(); break;
+		}
+	}
+}
+
+Tank DecodeTank(JsonReader& reader, PlayerRegistry& players) {
+	Tank tank{};
+	bool hasOwnerId = false;
+	bool hasDirection = false;
+	bool hasTurret = false;
+	bool hasTurretDirection = false;
+
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		switch (KeyHash(key)) {
+			case KeyHash("ownerId"):
+				if (reader.ReadNull()) break;
+				tank.ownerId = players.Intern(reader.ReadString());
+				hasOwnerId = true;
+				break;
+			case KeyHash("direction"):
+				if (reader.ReadNull()) break;
+				tank.direction = static_cast<Direction>(reader.ReadInt());
+				hasDirection = true;
+				break;
+			case KeyHash("turret"):
+				if (reader.ReadNull()) break;
+				hasTurret = true;
+				reader.BeginObject();
+				for (std::string_view turretKey; reader.NextKey(turretKey);) {
+					switch (KeyHash(turretKey)) {
+						case KeyHash("direction"):
+							if (reader.ReadNull()) break;
+							tank.turret.direction = static_cast<Direction>(reader.ReadInt());
+							hasTurretDirection = true;
+							break;
+						case KeyHash("bulletCount"): tank.turret.bulletCount = ReadNullableInt(reader); break;
+						case KeyHash("ticksToRegenBullet"): tank.turret.ticksToRegenBullet = ReadNullableInt(reader); break;
+						default: reader.Skip(); break;
+					}
+				}
+				break;
+			case KeyHash("health"): tank.health = ReadNullableInt(reader); break;
+			case KeyHash("secondaryItem"):
+				if (reader.ReadNull()) break;
+				tank.secondaryItem = static_cast<SecondaryItemType>(reader.ReadInt());
+				break;
+			default: reader.Skip(); break;
+		}
+	}
+
+	if (!hasOwnerId) throw std::runtime_error("Missing or null ownerId in tank payload.");
+	if (!hasDirection) throw std::runtime_error("Missing or null direction in tank payload.");
+	if (!hasTurret) throw std::runtime_error("Missing turret in tank payload.");
+	if (!hasTurretDirection) throw std::runtime_error("Missing or null turret direction.");
+	return tank;
+}
+
+std::optional<TileVariant> DecodeTileObjectPayload(JsonReader& reader, uint32_t type, PlayerRegistry& players) {
+	switch (type) {
+		case KeyHash("tank"):
+			return DecodeTank(reader, players);
+		case KeyHash("bullet"): {
+			Bullet bullet{};
+			reader.BeginObject();
+			for (std::string_view key; reader.NextKey(key);) {
+				switch (KeyHash(key)) {
+					case KeyHash("id"): bullet.id = static_cast<int>(reader.ReadInt()); break;
+					case KeyHash("speed"): bullet.speed = reader.ReadDouble(); break;
+					case KeyHash("direction"): bullet.direction = static_cast<Direction>(reader.ReadInt()); break;
+					case KeyHash("type"): bullet.type = static_cast<BulletType>(reader.ReadInt()); break;
+					default: reader.Skip(); break;
+				}
+			}
+			return bullet;
+		}
+		case KeyHash("item"): {
+			Item item{};
+			reader.BeginObject();
+			for (std::string_view key; reader.NextKey(key);) {
+				if (KeyHash(key) == KeyHash("type")) item.type = static_cast<ItemType>(reader.ReadInt());
+				else reader.Skip();
+			}
+			return item;
+		}
+		case KeyHash("laser"): {
+			Laser laser{};
+			reader.BeginObject();
+			for (std::string_view key; reader.NextKey(key);) {
+				switch (KeyHash(key)) {
+					case KeyHash("id"): laser.id = static_cast<int>(reader.ReadInt()); break;
+					case KeyHash("orientation"): laser.orientation = static_cast<LaserOrientation>(reader.ReadInt()); break;
+					default: reader.Skip(); break;
+				}
+			}
+			return laser;
+		}
+		case KeyHash("mine"): {
+			Mine mine{};
+			reader.BeginObject();
+			for (std::string_view key; reader.NextKey(key);) {
+				switch (KeyHash(key)) {
+					case KeyHash("id"): mine.id = static_cast<int>(reader.ReadInt()); break;
+					case KeyHash("explosionRemainingTicks"): mine.explosionRemainingTicks = ReadNullableInt(reader); break;
+					default: reader.Skip(); break;
+				}
+			}
+			return mine;
+		}
+		default:
+			reader.Skip();
+			return std::nullopt;
+	}
+}
+
+/// Decodes one object on tile (x, y) into the grid. Walls are static and never
+/// stored, returns true if the object was one.
+bool DecodeTileObject(JsonReader& reader, Grid& grid, int x, int y, PlayerRegistry& players) {
+	std::optional<uint32_t> type;
+	std::optional<size_t> payloadAt;
+	bool empty = true;
+	bool decoded = false;
+
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		empty = false;
+		switch (KeyHash(key)) {
+			case KeyHash("type"):
+				type = KeyHash(reader.ReadString());
+				break;
+			case KeyHash("payload"):
+				if (!type) {
+					// Payload before type, come back to it once the type is known
+					payloadAt = reader.Position();
+					reader.Skip();
+				} else if (*type == KeyHash("wall")) {
+					// Wall has no additional properties
+					reader.Skip();
+				} else if (auto object = DecodeTileObjectPayload(reader, *type, players)) {
+					grid.AddObject(x, y, std::move(*object));
+				}
+				decoded = type.has_value();
+				break;
+			default: reader.Skip(); break;
+		}
+	}
+
+	// Empty objects carry nothing
+	if (empty) return false;
+	if (!type) throw std::runtime_error("Missing type in tile object.");
+	if (*type == KeyHash("wall")) return true;
+	if (decoded) return false;
+	if (!payloadAt) throw std::runtime_error("Missing payload in tile object.");
+
+	size_t resumeAt = reader.Position();
+	reader.Seek(*payloadAt);
+	if (auto object = DecodeTileObjectPayload(reader, *type, players)) grid.AddObject(x, y, std::move(*object));
+	reader.Seek(resumeAt);
+	return false;
+}
+
+}
+
+void GameStateDecoder::Decode(std::string_view frame, GameState& gameState, std::string& id) {
+	JsonReader reader(frame);
+	bool hasPayload = false;
+
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		if (KeyHash(key) == KeyHash("payload")) {
+			DecodePayload(reader, gameState, id);
+			hasPayload = true;
+		} else {
+			reader.Skip();
+		}
+	}
+	if (!hasPayload) throw std::runtime_error("Missing payload in GameState packet.");
+
+	gameState.map.grid.IndexObjects();
+	staticMapCache.Finish(gameState.map);
+}
+
+void GameStateDecoder::StartMatch() {
+	staticMapCache.Reset();
+	players.Reset();
+}
+
+void GameStateDecoder::DecodePayload(JsonReader& reader, GameState& gameState, std::string& id) {
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		switch (KeyHash(key)) {
+			case KeyHash("id"):
+				id = reader.ReadString();
+				break;
+			case KeyHash("tick"):
+				gameState.time = static_cast<int>(reader.ReadInt());
+				break;
+			case KeyHash("players"):
+				DecodePlayers(reader, gameState.players, players);
+				break;
+			case KeyHash("map"):
+				DecodeMap(reader, gameState.map);
+				break;
+			default:
+				reader.Skip();
+				break;
+		}
+	}
+}
+
+void GameStateDecoder::DecodeMap(JsonReader& reader, Map& map) {
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		switch (KeyHash(key)) {
+			case KeyHash("zones"):
+				DecodeZones(reader, map.zones, players);
+				break;
+			case KeyHash("visibility"):
+				// Rows of '0'/'1' characters
+				reader.BeginArray();
+				for (int x = 0; reader.NextElement(); ++x) ApplyVisibilityRow(map.grid, x, reader.ReadString());
+				break;
+			case KeyHash("tiles"):
+				DecodeTiles(reader, map.grid);
+				break;
+			default:
+				reader.Skip();
+				break;
+		}
+	}
+}
+
+void GameStateDecoder::DecodeTiles(JsonReader& reader, Grid& grid) {
+	// First frame of the match, StaticMapCache::Finish builds the wall layer
+	StaticMapCache* walls = staticMapCache.Get() ? nullptr : &staticMapCache;
+	if (parallelTiles.Enabled()) {
+		parallelTiles.Decode(reader, grid, players, walls);
+		return;
+	}
+
+	int layers = 0;
+	int cells = 0;
+	reader.BeginArray();
+	for (int i = 0; reader.NextElement(); ++i) {
+		layers = i + 1;
+		cells = std::max(cells, DecodeTileLayer(reader, grid, i, players, walls));
+	}
+
+	SizeGrid(grid, std::max(layers, cells));
+}
+
+void GameStateDecoder::DecodePlayers(JsonReader& reader, std::pmr::vector<Player>& out, PlayerRegistry& players) {
+	reader.BeginArray();
+	while (reader.NextElement()) {
+		// Built in place so the nickname lands in the memory of out
+		DecodePlayer(reader, out.emplace_back(), players);
+	}
+}
+
+void GameStateDecoder::DecodeZones(JsonReader& reader, std::pmr::vector<Zone>& out, PlayerRegistry& players) {
+	reader.BeginArray();
+	while (reader.NextElement()) {
+		Zone zone{};
+		DecodeZone(reader, zone, players);
+		out.push_back(std::move(zone));
+	}
+}
+
+int GameStateDecoder::DecodeTileLayer(JsonReader& reader, Grid& grid, int i, PlayerRegistry& players, StaticMapCache* walls) {
+	// Server layer[i][j] is Grid tile (j, i)
+	int cells = 0;
+	reader.BeginArray();
+	for (int j = 0; reader.NextElement(); ++j) {
+		cells = j + 1;
+		bool wall = false;
+		reader.BeginArray();
+		while (reader.NextElement()) wall |= DecodeTileObject(reader, grid, j, i, players);
+		if (wall && walls) walls->RecordWall(j, i);
+	}
+	return cells;
+}
+
+void GameStateDecoder::ApplyVisibilityRow(Grid& grid, int x, std::string_view row) {
+	// The first row sizes the grid if the tiles have not
+	if (x == 0 && grid.dim == 0) grid.Resize(static_cast<int>(row.size()));
+	if (x >= grid.dim || row.size() != static_cast<size_t>(grid.dim)) {
+		throw std::runtime_error("Visibility does not match the grid dimension.");
+	}
+
+	Bitplane& visible = grid.Layer(GridLayer::visible);
+	for (int y = 0; y < grid.dim; ++y) {
+		if (row[y] == '1') visible.Set(x, y);
+	}
+}
+
+void GameStateDecoder::SizeGrid(Grid& grid, int dimension) {
+	if (grid.dim == 0) {
+		grid.Resize(dimension);
+	} else if (grid.dim != dimension) {
+		throw std::runtime_error("Tiles do not match the grid dimension.");
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "pch.h"
+#include "json-reader.h"
+#include "processed-packets.h"
+#include "static-map-cache.h"
+#include "player-registry.h"
+#include "parallel-tile-decoder.h"
+
+/// Builds a GameState straight from the bytes of a GameState frame in one
+/// forward pass, without materializing a JSON DOM. Keys are dispatched by
+/// switching on KeyHash, so members may arrive in any order; unknown keys are
+/// skipped. Walls and zone rasters come from the match's StaticMapCache, player
+/// IDs are interned into PlayerId handles. Tiles of large grids are decoded
+/// by a ParallelTileDecoder.
+class GameStateDecoder {
+ public:
+	/// Fills gameState from a complete GameState frame, id receives the gameStateId
+	void Decode(std::string_view frame, GameState& gameState, std::string& id);
+	/// Drops the cached static map and player IDs, called when a new match starts
+	void StartMatch();
+	/// gridDimension of the match from its LobbyData, turns parallel tile decoding on or off
+	void SetGridDimension(int gridDimension) { parallelTiles.StartMatch(gridDimension); }
+	/// Player IDs of the current match, lobby players are interned into it first
+	PlayerRegistry& Players() { return players; }
+	const StaticMapCache& StaticMaps() const { return staticMapCache; }
+
+	/// Sets the visible bits of Grid row x from a row of '0'/'1' characters,
+	/// the first row sizes a grid the tiles have not sized yet
+	static void ApplyVisibilityRow(Grid& grid, int x, std::string_view row);
+	/// Sizes a grid from the tiles, or checks them against the visibility rows
+	static void SizeGrid(Grid& grid, int dimension);
+
+	/// Parts of Decode that GameStateView also decodes on their own. The reader
+	/// is on the array of players or zones, or on one layer of the tiles.
+	static void DecodePlayers(JsonReader& reader, std::pmr::vector<Player>& out, PlayerRegistry& players);
+	static void DecodeZones(JsonReader& reader, std::pmr::vector<Zone>& out, PlayerRegistry& players);
+	/// Decodes server layer i of the tiles into grid and returns its number of
+	/// tiles, walls are reported to walls unless it is nullptr
+	static int DecodeTileLayer(JsonReader& reader, Grid& grid, int i, PlayerRegistry& players, StaticMapCache* walls);
+
+ private:
+	void DecodePayload(JsonReader& reader, GameState& gameState, std::string& id);
+	void DecodeMap(JsonReader& reader, Map& map);
+	void DecodeTiles(JsonReader& reader, Grid& grid);
+
+	StaticMapCache staticMapCache;
+	PlayerRegistry players;
+	ParallelTileDecoder parallelTiles;
+};
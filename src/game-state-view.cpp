@@ -0,0 +1,206 @@
+#include "game-state-view.h"
+#include "game-state-decoder.h"
+
+GameStateView::GameStateView(PlayerRegistry& players, const StaticMapCache& staticMapCache)
+: players(players), staticMapCache(staticMapCache) {}
+
+void GameStateView::Reset(std::string_view frame) {
+	this->frame = frame;
+	offsets.fill(std::string_view::npos);
+	payloadScan = {};
+	mapScan = {};
+	time.reset();
+	idDecoded = false;
+	playersDecoded = false;
+	zonesDecoded = false;
+	tilesIndexed = false;
+	visibilityIndexed = false;
+
+	// The payload is the only member of the frame worth locating
+	JsonReader reader(frame);
+	reader.BeginObject();
+	for (std::string_view key; reader.NextKey(key);) {
+		if (KeyHash(key) == KeyHash("payload")) {
+			payloadScan.position = reader.Position();
+			return;
+		}
+		reader.Skip();
+	}
+	throw std::runtime_error("Missing payload in GameState packet.");
+}
+
+size_t GameStateView::Locate(Member member) {
+	size_t& offset = offsets[static_cast<size_t>(member)];
+	if (offset != std::string_view::npos) return offset;
+
+	bool inMap = member == Member::tiles || member == Member::zones || member == Member::visibility;
+	ObjectScan& scan = inMap ? mapScan : payloadScan;
+	if (scan.position == std::string_view::npos) {
+		// Only the map can be unlocated, the payload is found by Reset
+		scan.position = Locate(Member::map);
+		if (scan.position == std::string_view::npos) return std::string_view::npos;
+	}
+
+	JsonReader reader(frame);
+	reader.Seek(scan.position);
+	if (!scan.begun) {
+		reader.BeginObject();
+		scan.begun = true;
+	}
+	if (scan.pendingSkip) {
+		reader.Skip();
+		scan.pendingSkip = false;
+	}
+
+	for (std::string_view key; !scan.done;) {
+		if (!reader.NextKey(key)) {
+			scan.done = true;
+			break;
+		}
+		Member found = Member::count;
+		switch (KeyHash(key)) {
+			case KeyHash("id"): if (!inMap) found = Member::id; break;
+			case KeyHash("tick"): if (!inMap) found = Member::tick; break;
+			case KeyHash("players"): if (!inMap) found = Member::players; break;
+			case KeyHash("map"): if (!inMap) found = Member::map; break;
+			case KeyHash("tiles"): if (inMap) found = Member::tiles; break;
+			case KeyHash("zones"): if (inMap) found = Member::zones; break;
+			case KeyHash("visibility"): if (inMap) found = Member::visibility; break;
+		}
+		reader.Peek();
+		scan.position = reader.Position();
+		if (found != Member::count) offsets[static_cast<size_t>(found)] = scan.position;
+		if (found == member) {
+			// Whoever asked reads the value, the next scan steps over it
+			scan.pendingSkip = true;
+			return scan.position;
+		}
+		reader.Skip();
+		scan.position = reader.Position();
+	}
+	return std::string_view::npos;
+}
+
+std::string_view GameStateView::Id() {
+	if (!idDecoded) {
+		size_t at = Locate(Member::id);
+		if (at == std::string_view::npos) throw std::runtime_error("Missing id in GameState payload.");
+		JsonReader reader(frame);
+		reader.Seek(at);
+		id = reader.ReadString();
+		idDecoded = true;
+	}
+	return id;
+}
+
+int GameStateView::Time() {
+	if (!time) {
+		size_t at = Locate(Member::tick);
+		if (at == std::string_view::npos) throw std::runtime_error("Missing tick in GameState payload.");
+		JsonReader reader(frame);
+		reader.Seek(at);
+		time = static_cast<int>(reader.ReadInt());
+	}
+	return *time;
+}
+
+const std::pmr::vector<Player>& GameStateView::Players() {
+	if (!playersDecoded) {
+		playerList.clear();
+		size_t at = Locate(Member::players);
+		if (at != std::string_view::npos) {
+			JsonReader reader(frame);
+			reader.Seek(at);
+			GameStateDecoder::DecodePlayers(reader, playerList, players);
+		}
+		playersDecoded = true;
+	}
+	return playerList;
+}
+
+const std::pmr::vector<Zone>& GameStateView::Zones() {
+	if (!zonesDecoded) {
+		zoneList.clear();
+		size_t at = Locate(Member::zones);
+		if (at != std::string_view::npos) {
+			JsonReader reader(frame);
+			reader.Seek(at);
+			GameStateDecoder::DecodeZones(reader, zoneList, players);
+		}
+		zonesDecoded = true;
+	}
+	return zoneList;
+}
+
+int GameStateView::Dim() {
+	IndexTiles();
+	return grid.dim;
+}
+
+bool GameStateView::IsVisible(int x, int y) {
+	IndexVisibility();
+	if (x < 0 || x >= static_cast<int>(visibilityRows.size())) return false;
+	std::string_view row = visibilityRows[x];
+	return y >= 0 && y < static_cast<int>(row.size()) && row[y] == '1';
+}
+
+const Grid& GameStateView::Tiles() {
+	IndexTiles();
+	for (int i = 0; i < grid.dim; ++i) DecodeLayer(i);
+	return grid;
+}
+
+void GameStateView::IndexTiles() {
+	if (tilesIndexed) return;
+	tilesIndexed = true;
+	layers.clear();
+	grid.tanks.clear();
+	grid.bullets.clear();
+	grid.lasers.clear();
+	grid.mines.clear();
+	grid.items.clear();
+
+	size_t at = Locate(Member::tiles);
+	if (at != std::string_view::npos) {
+		// Layers are only stepped over here, their objects are decoded on demand
+		JsonReader reader(frame);
+		reader.Seek(at);
+		reader.BeginArray();
+		while (reader.NextElement()) {
+			layers.push_back(reader.Position());
+			reader.Skip();
+		}
+	}
+	grid.Resize(static_cast<int>(layers.size()));
+	decodedLayers.assign(layers.size(), false);
+}
+
+void GameStateView::IndexVisibility() {
+	if (visibilityIndexed) return;
+	visibilityIndexed = true;
+	visibilityRows.clear();
+
+	size_t at = Locate(Member::visibility);
+	if (at == std::string_view::npos) return;
+	JsonReader reader(frame);
+	reader.Seek(at);
+	reader.BeginArray();
+	while (reader.NextElement()) {
+		// Rows of '0'/'1' never hold escapes, so the views point into the frame
+		visibilityRows.push_back(reader.ReadString());
+	}
+}
+
+void GameStateView::DecodeLayer(int i) {
+	IndexTiles();
+	if (i < 0 || i >= static_cast<int>(layers.size()) || decodedLayers[i]) return;
+	decodedLayers[i] = true;
+
+	JsonReader reader(frame);
+	reader.Seek(layers[i]);
+	// Walls belong to the static map, they are not recorded again
+	if (GameStateDecoder::DecodeTileLayer(reader, grid, i, players, nullptr) > grid.dim) {
+		throw std::runtime_error("Tiles do not match the grid dimension.");
+	}
+	grid.IndexObjects();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "pch.h"
+#include "json-reader.h"
+#include "processed-packets.h"
+#include "static-map-cache.h"
+#include "player-registry.h"
+
+/// Lazy alternative to a decoded GameState, for bots that can answer a tick
+/// from a few fields. Members of the payload are located the first time they
+/// are asked for, each by one resumed scan of the frame; the tiles and
+/// visibility rows are indexed once and a layer of tiles is decoded only when
+/// one of its tiles is looked at. Valid until the next Reset, the frame must
+/// outlive it.
+class GameStateView {
+ public:
+	GameStateView(PlayerRegistry& players, const StaticMapCache& staticMapCache);
+
+	/// Starts viewing a GameState frame, nothing is decoded yet
+	void Reset(std::string_view frame);
+
+	std::string_view Id();
+	/// tick number
+	int Time();
+	const std::pmr::vector<Player>& Players();
+	const std::pmr::vector<Zone>& Zones();
+	/// Walls and zones of the match, nullptr until a GameState of the match was fully decoded
+	const StaticMap* Static() const { return staticMapCache.Get(); }
+
+	/// Size of the grid, from the number of tile layers
+	int Dim();
+	bool IsVisible(int x, int y);
+	/// Objects of type T on Grid tile (x, y), see Grid::Find and Grid::Any
+	template <typename T>
+	const T* Find(int x, int y) {
+		DecodeLayer(y);
+		return grid.Find<T>(x, y);
+	}
+	template <typename T, typename F>
+	bool Any(int x, int y, F&& predicate) {
+		DecodeLayer(y);
+		return grid.Any<T>(x, y, std::forward<F>(predicate));
+	}
+	/// Grid with every layer of tiles decoded, walls are in Static()
+	const Grid& Tiles();
+
+ private:
+	enum class Member { id, tick, players, map, tiles, zones, visibility, count };
+
+	/// Resumable walk over the members of one object of the frame
+	struct ObjectScan {
+		/// Where to continue, npos until the object itself is located
+		size_t position = std::string_view::npos;
+		bool begun = false;
+		bool done = false;
+		/// The value at position was located but not skipped yet
+		bool pendingSkip = false;
+	};
+
+	/// Start of the value of member, npos if the frame has none
+	size_t Locate(Member member);
+	void IndexTiles();
+	void IndexVisibility();
+	/// Decodes server layer i of the tiles, which holds Grid column y = i
+	void DecodeLayer(int i);
+
+	PlayerRegistry& players;
+	const StaticMapCache& staticMapCache;
+
+	std::string_view frame;
+	std::array<size_t, static_cast<size_t>(Member::count)> offsets;
+	ObjectScan payloadScan;
+	ObjectScan mapScan;
+
+	/// Decoded parts keep their capacity from frame to frame
+	std::optional<int> time;
+	std::string id;
+	bool idDecoded = false;
+	std::pmr::vector<Player> playerList;
+	bool playersDecoded = false;
+	std::pmr::vector<Zone> zoneList;
+	bool zonesDecoded = false;
+	/// Start of every layer of tiles, empty until the tiles are first needed
+	std::vector<size_t> layers;
+	bool tilesIndexed = false;
+	std::vector<std::string_view> visibilityRows;
+	bool visibilityIndexed = false;
+	Grid grid;
+	std::vector<bool> decodedLayers;
+};
@@ -4,21 +4,30 @@
 #include "bot/bot.h"
 #include "processed-packets.h"
 #include "packet.h"
+#include "message-sender.h"
+#include "action-serializer.h"
+#include "packet-parser.h"
+#include "tick-arena.h"
 
 class Handler {
  public:
-	Handler(Bot *botPtr, std::queue<std::string> *messagesToSendPtr, std::mutex *mtxPtr, std::condition_variable *cvPtr);
-	void HandleLobbyData(nlohmann::json payload);
-	void HandleGameState(nlohmann::json payload);
-	void HandleGameEnded(nlohmann::json payload);
+	Handler(Bot *botPtr, PacketParser *parserPtr, MessageSender sender);
+	/// Handlers take the whole received frame and decode it with the PacketParser
+	void HandleLobbyData(const std::string& frame);
+	void HandleGameState(const std::string& frame);
+	void HandleGameEnded(const std::string& frame);
     void HandleGameStarting();
     void OnWarningReceived(WarningType warningType, std::optional<std::string> message);
 
  private:
-	static std::string ResponseToString(const ResponseVariant& response, std::string& id);
-	void SendResponse(const ResponseVariant& response, std::string& id);
+	void SendResponse(const ResponseVariant& response, std::string_view id);
 	Bot *botPtr;
-	std::queue<std::string> *messagesToSendPtr;
-	std::mutex *mtxPtr;
-	std::condition_variable *cvPtr;
+	PacketParser *parserPtr;
+	MessageSender sender;
+	/// Reused for every action, see ActionSerializer
+	OutboundPacket responsePacket;
+	/// Memory of the tick being handled, sized for the grid of the match
+	TickArena arena;
+	/// gameStateId of the tick being handled, keeps its capacity between ticks
+	std::string gameStateId;
 };
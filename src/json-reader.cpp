@@ -0,0 +1,263 @@
+#include "json-reader.h"
+
+namespace {
+
+int HexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void AppendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+}
+
+JsonReader::JsonReader(std::string_view json) : json(json) {}
+
+char JsonReader::Peek() {
+    while (pos < json.size()) {
+        char c = json[pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return c;
+        ++pos;
+    }
+    return '\0';
+}
+
+void JsonReader::BeginObject() {
+    Expect('{');
+}
+
+bool JsonReader::NextKey(std::string_view& key) {
+    char c = Peek();
+    if (c == ',') {
+        ++pos;
+        c = Peek();
+    }
+    if (c == '}') {
+        ++pos;
+        return false;
+    }
+    key = ReadString();
+    Expect(':');
+    return true;
+}
+
+void JsonReader::BeginArray() {
+    Expect('[');
+}
+
+bool JsonReader::NextElement() {
+    char c = Peek();
+    if (c == ',') {
+        ++pos;
+        c = Peek();
+    }
+    if (c == ']') {
+        ++pos;
+        return false;
+    }
+    if (c == '\0') Fail("unterminated array");
+    return true;
+}
+
+std::string_view JsonReader::ReadString() {
+    Expect('"');
+    size_t begin = pos;
+    for (; pos < json.size(); ++pos) {
+        char c = json[pos];
+        if (c == '"') {
+            return json.substr(begin, pos++ - begin);
+        }
+        if (c == '\\') {
+            DecodeEscapes(begin);
+            return scratch;
+        }
+    }
+    Fail("unterminated string");
+}
+
+int64_t JsonReader::ReadInt() {
+    Peek();
+    size_t end = NumberEnd();
+    int64_t value = 0;
+    auto [last, ec] = std::from_chars(json.data() + pos, json.data() + end, value);
+    if (ec != std::errc{}) Fail("expected an integer");
+    // Fraction or exponent, truncate like nlohmann's get<int>() does
+    if (last != json.data() + end) return static_cast<int64_t>(ReadDouble());
+    pos = end;
+    return value;
+}
+
+double JsonReader::ReadDouble() {
+    Peek();
+    size_t end = NumberEnd();
+    double value = 0;
+    auto [last, ec] = std::from_chars(json.data() + pos, json.data() + end, value);
+    if (ec != std::errc{} || last != json.data() + end) Fail("expected a number");
+    pos = end;
+    return value;
+}
+
+bool JsonReader::ReadBool() {
+    char c = Peek();
+    if (c == 't') {
+        ExpectLiteral("true");
+        return true;
+    }
+    if (c == 'f') {
+        ExpectLiteral("false");
+        return false;
+    }
+    Fail("expected a boolean");
+}
+
+bool JsonReader::ReadNull() {
+    if (Peek() != 'n') return false;
+    ExpectLiteral("null");
+    return true;
+}
+
+void JsonReader::Skip() {
+    switch (Peek()) {
+        case '{':
+        case '[': {
+            // Only strings can hide brackets, everything else is counted as is
+            int depth = 0;
+            while (pos < json.size()) {
+                char c = json[pos];
+                if (c == '"') {
+                    SkipString();
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if ((c == '}' || c == ']') && --depth == 0) {
+                    ++pos;
+                    return;
+                }
+                ++pos;
+            }
+            Fail("unterminated array or object");
+        }
+        case '"':
+            SkipString();
+            return;
+        case 't':
+            ExpectLiteral("true");
+            return;
+        case 'f':
+            ExpectLiteral("false");
+            return;
+        case 'n':
+            ExpectLiteral("null");
+            return;
+        default: {
+            size_t end = NumberEnd();
+            if (end == pos) Fail("unexpected character");
+            pos = end;
+            return;
+        }
+    }
+}
+
+void JsonReader::SkipString() {
+    for (++pos; pos < json.size(); ++pos) {
+        if (json[pos] == '\\') {
+            ++pos;
+        } else if (json[pos] == '"') {
+            ++pos;
+            return;
+        }
+    }
+    Fail("unterminated string");
+}
+
+void JsonReader::Fail(const char* what) const {
+    throw std::runtime_error("JSON parse error at offset " + std::to_string(pos) + ": " + what);
+}
+
+void JsonReader::Expect(char c) {
+    if (Peek() != c) Fail("unexpected character");
+    ++pos;
+}
+
+void JsonReader::ExpectLiteral(std::string_view literal) {
+    if (json.substr(pos, literal.size()) != literal) Fail("invalid literal");
+    pos += literal.size();
+}
+
+size_t JsonReader::NumberEnd() const {
+    size_t end = pos;
+    while (end < json.size()) {
+        char c = json[end];
+        if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') break;
+        ++end;
+    }
+    return end;
+}
+
+// Slow path of ReadString, pos is on the first backslash of the string starting at begin
+void JsonReader::DecodeEscapes(size_t begin) {
+    scratch.assign(json.data() + begin, pos - begin);
+    while (pos < json.size()) {
+        char c = json[pos++];
+        if (c == '"') return;
+        if (c != '\\') {
+            scratch += c;
+            continue;
+        }
+        if (pos >= json.size()) break;
+        switch (json[pos++]) {
+            case '"': scratch += '"'; break;
+            case '\\': scratch += '\\'; break;
+            case '/': scratch += '/'; break;
+            case 'b': scratch += '\b'; break;
+            case 'f': scratch += '\f'; break;
+            case 'n': scratch += '\n'; break;
+            case 'r': scratch += '\r'; break;
+            case 't': scratch += '\t'; break;
+            case 'u': {
+                auto readHex = [this]() {
+                    if (pos + 4 > json.size()) Fail("truncated \\u escape");
+                    uint32_t value = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        int digit = HexDigit(json[pos++]);
+                        if (digit < 0) Fail("invalid \\u escape");
+                        value = (value << 4) | digit;
+                    }
+                    return value;
+                };
+                uint32_t codePoint = readHex();
+                if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+                    if (json.substr(pos, 2) != "\\u") Fail("unpaired surrogate");
+                    pos += 2;
+                    uint32_t low = readHex();
+                    if (low < 0xDC00 || low >= 0xE000) Fail("unpaired surrogate");
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                AppendUtf8(scratch, codePoint);
+                break;
+            }
+            default:
+                Fail("invalid escape");
+        }
+    }
+    Fail("unterminated string");
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "pch.h"
+
+/// FNV-1a, used to switch on object keys and enum-like string values
+constexpr uint32_t KeyHash(std::string_view key) {
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/// Forward-only pull tokenizer over a complete JSON text. Values are read in
+/// document order without building a tree; strings are returned as views into
+/// the input unless they contain escapes, in which case they are decoded into
+/// an internal buffer that stays valid until the next string is read.
+/// Malformed input throws std::runtime_error.
+class JsonReader {
+ public:
+    explicit JsonReader(std::string_view json);
+
+    /// Next significant character, '\0' at the end of input
+    char Peek();
+
+    void BeginObject();
+    /// Reads the next key of the current object, false once it is closed
+    bool NextKey(std::string_view& key);
+    void BeginArray();
+    /// Positions on the next element of the current array, false once it is closed
+    bool NextElement();
+
+    std::string_view ReadString();
+    int64_t ReadInt();
+    double ReadDouble();
+    bool ReadBool();
+    /// Consumes a null literal, false (and nothing consumed) for any other value
+    bool ReadNull();
+    /// Skips the next value of any type. Arrays and objects are skipped in one
+    /// flat scan that only checks their brackets balance.
+    void Skip();
+
+    size_t Position() const { return pos; }
+    /// Rewinds or fast-forwards to a position previously returned by Position()
+    void Seek(size_t position) { pos = position; }
+
+ private:
+    [[noreturn]] void Fail(const char* what) const;
+    void Expect(char c);
+    void ExpectLiteral(std::string_view literal);
+    /// Moves past the string starting at pos
+    void SkipString();
+    size_t NumberEnd() const;
+    void DecodeEscapes(size_t begin);
+
+    std::string_view json;
+    size_t pos = 0;
+    std::string scratch;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "pch.h"
+#include "outbound-scheduler.h"
+
+/// Outbound handle given to Handler. Serialized packets are pushed onto one of
+/// the transport's lanes (see OutboundScheduler); each lane has a single
+/// producer, which for every lane but Pong is the processing thread.
+/// The optional wakeup lets a transport that does not park on the scheduler
+/// (the async strand) learn that there is something to write.
+class MessageSender {
+ public:
+	explicit MessageSender(OutboundScheduler& scheduler, std::function<void()> wakeup = {})
+		: scheduler(&scheduler), wakeup(std::move(wakeup)) {}
+
+	void Send(const OutboundPacket& packet, OutboundLane lane) const {
+		if (!scheduler->Push(lane, packet)) return;
+		if (wakeup) wakeup();
+	}
+
+	/// Same as Send without ever parking, false if the packet was dropped because its lane is full
+	bool TrySend(const OutboundPacket& packet, OutboundLane lane) const {
+		if (!scheduler->TryPush(lane, packet)) return false;
+		if (wakeup) wakeup();
+		return true;
+	}
+
+ private:
+	OutboundScheduler* scheduler;
+	std::function<void()> wakeup;
+};
@@ -0,0 +1,86 @@
+#include "nlohmann-packet-parser.h"
+#include <nlohmann/json.hpp>
+
+PacketType NlohmannPacketParser::ParseType(const std::string& frame) {
+	auto jsonMessage = nlohmann::json::parse(frame);
+	return static_cast<PacketType>(jsonMessage.at("type").get<uint64_t>());
+}
+
+void NlohmannPacketParser::ParseGameState(const std::string& frame, GameState& gameState, std::string& id) {
+	// Single pass over the frame, no JSON DOM is built
+	gameStateDecoder.Decode(frame, gameState, id);
+}
+
+GameStateView& NlohmannPacketParser::ViewGameState(const std::string& frame) {
+	gameStateView.Reset(frame);
+	return gameStateView;
+}
+
+LobbyData NlohmannPacketParser::ParseLobbyData(const std::string& frame) {
+	gameStateDecoder.StartMatch();
+	PlayerRegistry& players = gameStateDecoder.Players();
+
+	auto jsonMessage = nlohmann::json::parse(frame);
+	const auto& payload = jsonMessage.at("payload");
+	LobbyData lobbyData;
+
+	// Extract players array and populate the players vector, in order so handles match indices
+	for (const auto& player : payload.at("players")) {
+		LobbyPlayer lobbyPlayer;
+		lobbyPlayer.id = player.at("id").get<std::string>();
+		lobbyPlayer.nickname = player.at("nickname").get<std::string>();
+		lobbyPlayer.color = player.at("color").get<uint32_t>();
+
+		players.Intern(lobbyPlayer.id);
+		lobbyData.players.push_back(lobbyPlayer);
+	}
+
+	// Extract the playerId
+	lobbyData.myId = players.Intern(payload.at("playerId").get<std::string>());
+
+	// Extract server settings from the nested object
+	const auto& serverSettings = payload.at("serverSettings");
+
+
+    if (serverSettings.contains("matchName") && !serverSettings["matchName"].is_null()) {
+        lobbyData.matchName = serverSettings.at("matchName").get<std::string>();
+    }
+    lobbyData.sandboxMode = serverSettings.at("sandboxMode").get<bool>();
+	lobbyData.gridDimension = serverSettings.at("gridDimension").get<int>();
+	gameStateDecoder.SetGridDimension(lobbyData.gridDimension);
+	lobbyData.numberOfPlayers = serverSettings.at("numberOfPlayers").get<int>();
+	lobbyData.seed = serverSettings.at("seed").get<int>();
+	lobbyData.broadcastInterval = serverSettings.at("broadcastInterval").get<int>();
+	lobbyData.eagerBroadcast = serverSettings.at("eagerBroadcast").get<bool>();
+	lobbyData.version = serverSettings.at("version").get<std::string>();
+
+	return lobbyData;
+}
+
+EndGameLobby NlohmannPacketParser::ParseGameEnded(const std::string& frame) {
+	auto jsonMessage = nlohmann::json::parse(frame);
+    EndGameLobby endGameLobby;
+
+    // Extract players array and populate the players vector
+    for (const auto& player : jsonMessage.at("payload").at("players")) {
+        EndGamePlayer lobbyPlayer;
+        lobbyPlayer.id = player.at("id").get<std::string>();
+        lobbyPlayer.nickname = player.at("nickname").get<std::string>();
+        lobbyPlayer.color = player.at("color").get<uint32_t>();
+        lobbyPlayer.score = player.at("score").get<int>();
+
+        endGameLobby.players.push_back(lobbyPlayer);
+    }
+
+    return endGameLobby;
+}
+
+std::optional<std::string> NlohmannPacketParser::ParsePayloadString(const std::string& frame, std::string_view key) {
+	auto jsonMessage = nlohmann::json::parse(frame);
+	if (!jsonMessage.contains("payload")) return std::nullopt;
+
+	const auto& payload = jsonMessage["payload"];
+	auto it = payload.find(key);
+	if (it == payload.end() || it->is_null()) return std::nullopt;
+	return it->get<std::string>();
+}
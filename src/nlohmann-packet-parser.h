@@ -0,0 +1,29 @@
+#pragma once
+
+#include "pch.h"
+#include "packet.h"
+#include "processed-packets.h"
+#include "game-state-decoder.h"
+#include "game-state-view.h"
+
+/// Default JSON backend: control packets go through nlohmann::json, GameState
+/// frames through the single-pass GameStateDecoder.
+class NlohmannPacketParser {
+ public:
+	/// Bytes past the end of a frame the parser may read
+	static constexpr size_t FRAME_PADDING = 0;
+
+	/// Only needed for frames the reader could not classify
+	PacketType ParseType(const std::string& frame);
+	void ParseGameState(const std::string& frame, GameState& gameState, std::string& id);
+	/// Lazy view of a GameState frame, reused for every frame, see GameStateView
+	GameStateView& ViewGameState(const std::string& frame);
+	LobbyData ParseLobbyData(const std::string& frame);
+	EndGameLobby ParseGameEnded(const std::string& frame);
+	/// String member of the payload, std::nullopt if missing or null
+	std::optional<std::string> ParsePayloadString(const std::string& frame, std::string_view key);
+
+ private:
+	GameStateDecoder gameStateDecoder;
+	GameStateView gameStateView{gameStateDecoder.Players(), gameStateDecoder.StaticMaps()};
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "pch.h"
+
+/// Serialized outbound packet stored inline. Everything the bot sends is a
+/// short JSON object (actions, Pong, lobby/game-state requests), so a fixed
+/// capacity keeps the whole send path free of heap allocations.
+class OutboundPacket {
+ public:
+	static constexpr size_t CAPACITY = 256;
+
+	OutboundPacket() = default;
+
+	explicit OutboundPacket(std::string_view bytes) {
+		if (!Append(bytes)) throw std::length_error("Outbound packet exceeds capacity");
+	}
+
+	/// Returns false and leaves the packet unchanged if bytes do not fit
+	bool Append(std::string_view bytes) {
+		if (bytes.size() > CAPACITY - size) return false;
+		std::memcpy(data.data() + size, bytes.data(), bytes.size());
+		size += bytes.size();
+		return true;
+	}
+
+	bool Append(char c) {
+		if (size == CAPACITY) return false;
+		data[size++] = c;
+		return true;
+	}
+
+	void Clear() {
+		size = 0;
+	}
+
+	std::string_view View() const {
+		return {data.data(), size};
+	}
+
+	const char* Data() const {
+		return data.data();
+	}
+
+	size_t Size() const {
+		return size;
+	}
+
+ private:
+	std::array<char, CAPACITY> data;
+	size_t size = 0;
+};
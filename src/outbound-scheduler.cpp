@@ -0,0 +1,70 @@
+#include "outbound-scheduler.h"
+
+OutboundScheduler::OutboundScheduler(size_t laneCapacity)
+	: actions(laneCapacity), pongs(laneCapacity), housekeeping(laneCapacity) {}
+
+bool OutboundScheduler::Push(OutboundLane lane, const OutboundPacket& packet) {
+	if (!Ring(lane).Push(packet)) return false;
+	writerSignal.Notify();
+	return true;
+}
+
+bool OutboundScheduler::TryPush(OutboundLane lane, const OutboundPacket& packet) {
+	if (closed.load(std::memory_order_acquire)) return false;
+	OutboundPacket copy = packet;
+	if (!Ring(lane).TryPush(copy)) return false;
+	writerSignal.Notify();
+	return true;
+}
+
+std::optional<OutboundPacket> OutboundScheduler::TryPop() {
+	// Actions are produced in tick order, only the newest one is still relevant
+	while (auto action = actions.TryPop()) {
+		if (pendingAction) ++supersededActions;
+		pendingAction = std::move(action);
+	}
+	if (pendingAction) {
+		std::optional<OutboundPacket> action = pendingAction;
+		pendingAction.reset();
+		return action;
+	}
+
+	if (auto pong = pongs.TryPop()) return pong;
+	return housekeeping.TryPop();
+}
+
+std::optional<OutboundPacket> OutboundScheduler::Pop() {
+	while (true) {
+		if (auto message = TryPop()) return message;
+		if (closed.load(std::memory_order_seq_cst)) return std::nullopt;
+		writerSignal.Wait([this]() { return !Empty() || closed.load(std::memory_order_seq_cst); });
+	}
+}
+
+bool OutboundScheduler::Empty() const {
+	return !pendingAction && actions.Empty() && pongs.Empty() && housekeeping.Empty();
+}
+
+void OutboundScheduler::Close() {
+	closed.store(true, std::memory_order_seq_cst);
+	actions.Close();
+	pongs.Close();
+	housekeeping.Close();
+	writerSignal.NotifyAll();
+}
+
+size_t OutboundScheduler::SupersededActions() const {
+	return supersededActions;
+}
+
+SpscRing<OutboundPacket>& OutboundScheduler::Ring(OutboundLane lane) {
+	switch (lane) {
+		case OutboundLane::Action:
+			return actions;
+		case OutboundLane::Pong:
+			return pongs;
+		case OutboundLane::Housekeeping:
+		default:
+			return housekeeping;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "pch.h"
+#include "spsc-ring.h"
+#include "outbound-packet.h"
+
+/// Outbound lanes in the order the writer drains them
+enum class OutboundLane {
+	/// Response to the current GameState; an action superseded by a newer one is never sent
+	Action,
+	/// Pong replies, they feed the ping the server measures for us
+	Pong,
+	/// LobbyDataRequest, ReadyToReceiveGameState and other packets that are not time critical
+	Housekeeping,
+};
+
+/// Prioritized outbound queue between the packet producers and the socket writer.
+/// Every lane is its own SPSC ring, so each lane must have a single producer
+/// thread; the writer is the only consumer. Whenever the writer picks the next
+/// packet, a queued action goes first (older queued actions are discarded),
+/// then a Pong, then housekeeping packets in FIFO order.
+class OutboundScheduler {
+ public:
+	explicit OutboundScheduler(size_t laneCapacity = 16);
+
+	/// Producer side, returns false once the scheduler is closed
+	bool Push(OutboundLane lane, const OutboundPacket& packet);
+	/// Producer side, never parks: false if the lane is full or the scheduler is closed
+	bool TryPush(OutboundLane lane, const OutboundPacket& packet);
+
+	/// Writer side, highest priority packet if any
+	std::optional<OutboundPacket> TryPop();
+	/// Writer side, parks until a packet is queued; std::nullopt once closed and drained
+	std::optional<OutboundPacket> Pop();
+	/// Writer side, true if nothing is waiting in any lane
+	bool Empty() const;
+
+	void Close();
+
+	/// Number of actions dropped because a newer action was queued before they were written
+	size_t SupersededActions() const;
+
+ private:
+	SpscRing<OutboundPacket>& Ring(OutboundLane lane);
+
+	SpscRing<OutboundPacket> actions;
+	SpscRing<OutboundPacket> pongs;
+	SpscRing<OutboundPacket> housekeeping;
+	WakeSignal writerSignal;
+	std::atomic<bool> closed{false};
+
+	// Owned by the writer
+	std::optional<OutboundPacket> pendingAction;
+	size_t supersededActions = 0;
+};
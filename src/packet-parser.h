@@ -0,0 +1,11 @@
+#pragma once
+
+/// JSON backend for incoming packets, picked with the JSON_BACKEND CMake option.
+/// Every backend exposes the same members, see NlohmannPacketParser.
+#ifdef JSON_BACKEND_SIMDJSON
+#include "simdjson-packet-parser.h"
+using PacketParser = SimdjsonPacketParser;
+#else
+#include "nlohmann-packet-parser.h"
+using PacketParser = NlohmannPacketParser;
+#endif
@@ -1,5 +1,5 @@
 #pragma once
-#include <nlohmann/json.hpp>
+#include <string_view>
 
 enum class PacketType {
     // Mask for packet type indicating that it has a payload
@@ -50,8 +50,17 @@ enum class PacketType {
 };
 
 
-struct Packet {
-	PacketType packetType;
-	nlohmann::json payload;
-};
+/// Pre-serialized payload-less packets, sent without touching a JSON library
+inline constexpr std::string_view PONG_PACKET = R"({"type":18})";
+inline constexpr std::string_view LOBBY_DATA_REQUEST_PACKET = R"({"type":34})";
+inline constexpr std::string_view READY_TO_RECEIVE_GAME_STATE_PACKET = R"({"type":53})";
+static_assert(static_cast<int>(PacketType::Pong) == 18, "PONG_PACKET must match PacketType::Pong");
+static_assert(static_cast<int>(PacketType::LobbyDataRequest) == 34, "LOBBY_DATA_REQUEST_PACKET must match PacketType::LobbyDataRequest");
+static_assert(static_cast<int>(PacketType::ReadyToReceiveGameState) == 53, "READY_TO_RECEIVE_GAME_STATE_PACKET must match PacketType::ReadyToReceiveGameState");
 
+/// Rough upper bound of a GameState frame for a given grid, used to pre-size receive buffers.
+/// Most tiles serialize as "[]," while walls and objects take a few dozen bytes each.
+constexpr size_t EstimateGameStateFrameSize(int gridDimension) {
+    size_t tiles = static_cast<size_t>(gridDimension) * gridDimension;
+    return tiles * 24 + 4096;
+}
@@ -0,0 +1,126 @@
+#include "parallel-tile-decoder.h"
+#include "game-state-decoder.h"
+
+namespace {
+
+template <typename T>
+void Append(std::pmr::vector<GridObject<T>>& to, std::pmr::vector<GridObject<T>>& from) {
+	to.insert(to.end(), from.begin(), from.end());
+	from.clear();
+}
+
+}
+
+ParallelTileDecoder::~ParallelTileDecoder() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& thread : threads) thread.join();
+}
+
+void ParallelTileDecoder::StartMatch(int gridDimension) {
+	size_t hardware = std::thread::hardware_concurrency();
+	enabled = gridDimension >= minDimension && hardware > 1;
+	if (!enabled || !threads.empty()) return;
+
+	// Shard 0 is decoded by the calling thread
+	shards.resize(std::min(MAX_THREADS, hardware));
+	for (size_t shard = 1; shard < shards.size(); ++shard) {
+		threads.emplace_back(&ParallelTileDecoder::Work, this, shard);
+	}
+}
+
+void ParallelTileDecoder::Decode(JsonReader& reader, Grid& grid, PlayerRegistry& players, StaticMapCache* walls) {
+	// Skipping a layer is much cheaper than decoding it
+	layers.clear();
+	reader.BeginArray();
+	while (reader.NextElement()) {
+		layers.push_back(reader.Position());
+		reader.Skip();
+	}
+	size_t end = reader.Position();
+
+	// Split at layer starts so every shard gets about the same number of bytes
+	int layerCount = static_cast<int>(layers.size());
+	size_t begin = layers.empty() ? end : layers.front();
+	int next = 0;
+	for (size_t k = 0; k < shards.size(); ++k) {
+		size_t limit = begin + (end - begin) * (k + 1) / shards.size();
+		shards[k].first = next;
+		while (next < layerCount && layers[next] < limit) ++next;
+		if (k + 1 == shards.size()) next = layerCount;
+		shards[k].last = next;
+	}
+
+	this->reader = &reader;
+	this->players = &players;
+	recordWalls = walls != nullptr;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		++generation;
+		running = shards.size() - 1;
+	}
+	wake.notify_all();
+	DecodeShard(shards[0]);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this] { return running == 0; });
+	}
+
+	int cells = 0;
+	for (auto& shard : shards) {
+		if (shard.error) std::rethrow_exception(shard.error);
+		Append(grid.tanks, shard.grid.tanks);
+		Append(grid.bullets, shard.grid.bullets);
+		Append(grid.lasers, shard.grid.lasers);
+		Append(grid.mines, shard.grid.mines);
+		Append(grid.items, shard.grid.items);
+		if (walls) walls->MergeWalls(shard.walls);
+		cells = std::max(cells, shard.cells);
+	}
+
+	GameStateDecoder::SizeGrid(grid, std::max(layerCount, cells));
+}
+
+void ParallelTileDecoder::Work(size_t shard) {
+	uint64_t seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) return;
+			seen = generation;
+		}
+
+		DecodeShard(shards[shard]);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--running == 0) done.notify_one();
+	}
+}
+
+void ParallelTileDecoder::DecodeShard(Shard& shard) {
+	// Left over from a frame that failed
+	shard.grid.tanks.clear();
+	shard.grid.bullets.clear();
+	shard.grid.lasers.clear();
+	shard.grid.mines.clear();
+	shard.grid.items.clear();
+	shard.walls.Reset();
+	shard.cells = 0;
+	shard.error = nullptr;
+
+	try {
+		// Readers keep no state besides the position, each thread seeks its own copy
+		JsonReader local = *reader;
+		for (int i = shard.first; i < shard.last; ++i) {
+			local.Seek(layers[i]);
+			int cells = GameStateDecoder::DecodeTileLayer(local, shard.grid, i, *players, recordWalls ? &shard.walls : nullptr);
+			shard.cells = std::max(shard.cells, cells);
+		}
+	} catch (...) {
+		shard.error = std::current_exception();
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "pch.h"
+#include "json-reader.h"
+#include "processed-packets.h"
+#include "static-map-cache.h"
+#include "player-registry.h"
+
+/// Smallest gridDimension decoded in parallel unless set at configure time
+#ifndef PARALLEL_PARSE_MIN_DIMENSION
+#define PARALLEL_PARSE_MIN_DIMENSION 64
+#endif
+
+/// Decodes the tiles of large grids on a small pool of persistent threads.
+/// Layers of the tiles are independent: one pass only finds where each layer
+/// starts, then contiguous runs of layers of about the same size in bytes are
+/// decoded at once, each into the side tables of its own shard. The shards
+/// are appended in layer order, so the Grid is the same as after a serial
+/// decode. The threads start with the first match whose grid reaches
+/// minDimension and stay parked between frames.
+class ParallelTileDecoder {
+ public:
+	/// Grids of at least this dimension are decoded in parallel
+	int minDimension = PARALLEL_PARSE_MIN_DIMENSION;
+
+	ParallelTileDecoder() = default;
+	ParallelTileDecoder(const ParallelTileDecoder&) = delete;
+	ParallelTileDecoder& operator=(const ParallelTileDecoder&) = delete;
+	~ParallelTileDecoder();
+
+	/// Called with the gridDimension of a new match
+	void StartMatch(int gridDimension);
+	/// True if the tiles of the current match are decoded in parallel
+	bool Enabled() const { return enabled; }
+
+	/// Decodes the tiles array the reader is on into grid and sizes the grid,
+	/// like GameStateDecoder's serial loop. Walls are reported to walls unless
+	/// it is nullptr. The reader is left after the array.
+	void Decode(JsonReader& reader, Grid& grid, PlayerRegistry& players, StaticMapCache* walls);
+
+ private:
+	/// Threads decoding a frame, the calling one included
+	static constexpr size_t MAX_THREADS = 4;
+
+	/// Run of layers decoded by one thread, kept from frame to frame
+	struct Shard {
+		int first = 0;
+		int last = 0;
+		/// Only the side tables are used, the shard grid is never sized
+		Grid grid;
+		StaticMapCache walls;
+		int cells = 0;
+		std::exception_ptr error;
+	};
+
+	void Work(size_t shard);
+	void DecodeShard(Shard& shard);
+
+	bool enabled = false;
+	std::vector<std::thread> threads;
+	std::vector<Shard> shards;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	uint64_t generation = 0;
+	size_t running = 0;
+	bool stopping = false;
+
+	// The frame being decoded, set before the threads are woken
+	const JsonReader* reader = nullptr;
+	PlayerRegistry* players = nullptr;
+	bool recordWalls = false;
+	/// Start of every layer, then the end of the last one
+	std::vector<size_t> layers;
+};
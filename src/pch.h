@@ -5,8 +5,20 @@
 #include <boost/beast.hpp>
 #include <string>
 #include <memory>
+#include <memory_resource>
 #include <future>
 #include <queue>
+#include <deque>
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <optional>
+#include <variant>
+#include <string_view>
+#include <array>
+#include <cstring>
+#include <charconv>
+#include <limits>
 #include <mutex>
 #include <condition_variable>
 #include <iostream>
@@ -15,7 +27,6 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <thread>
-#include <nlohmann/json.hpp>
 #include <stdexcept>
 #include <utility>
 #include <cstdlib>
@@ -0,0 +1,18 @@
+#include "player-registry.h"
+
+void PlayerRegistry::Reset() {
+	std::lock_guard<std::mutex> lock(mutex);
+	ids.clear();
+}
+
+PlayerId PlayerRegistry::Intern(std::string_view id) {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < ids.size(); ++i) {
+		if (ids[i] == id) return static_cast<PlayerId>(i);
+	}
+	if (ids.size() > std::numeric_limits<PlayerId>::max()) {
+		throw std::runtime_error("Too many players to intern.");
+	}
+	ids.emplace_back(id);
+	return static_cast<PlayerId>(ids.size() - 1);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "pch.h"
+#include "processed-packets.h"
+
+/// Interns the server's player ID strings into PlayerId handles for the
+/// current match. Lobby players are registered first, so their handle is
+/// their index in LobbyData::players. A handful of players is expected, IDs
+/// are looked up linearly. Intern is also called by the threads of
+/// ParallelTileDecoder, so it is serialized.
+class PlayerRegistry {
+ public:
+	/// Forgets all IDs, called when a new match starts
+	void Reset();
+	/// Handle of id, registered on first sight. Throws once every handle is taken.
+	PlayerId Intern(std::string_view id);
+	/// Server ID behind a handle
+	const std::string& Id(PlayerId player) const { return ids.at(player); }
+	size_t Size() const { return ids.size(); }
+
+ private:
+	std::mutex mutex;
+	std::vector<std::string> ids;
+};
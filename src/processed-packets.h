@@ -2,6 +2,10 @@
 
 #pragma once
 
+/// Per-match player handle interned by the parser from the server's string ID,
+/// lobby players get their index in LobbyData::players
+using PlayerId = uint8_t;
+
 /// First received list of players
 struct LobbyPlayer {
 	std::string id;
@@ -22,7 +26,7 @@ struct EndGameLobby {
 };
 
 struct LobbyData {
-	std::string myId;
+	PlayerId myId;
 	std::vector<LobbyPlayer> players;
     bool sandboxMode;
     std::optional<std::string> matchName;
@@ -50,6 +54,8 @@ struct Turret {
 	std::optional<int> bulletCount;
     /// Not present in enemies
 	std::optional<int> ticksToRegenBullet;
+
+	bool operator==(const Turret&) const = default;
 };
 
 enum class SecondaryItemType {
@@ -62,12 +68,14 @@ enum class SecondaryItemType {
 
 /// TankPayload struct
 struct Tank {
-	std::string ownerId;
+	PlayerId ownerId;
     Direction direction;
 	Turret turret;
     /// Not present in enemies
 	std::optional<int> health;
     std::optional<SecondaryItemType> secondaryItem;
+
+	bool operator==(const Tank&) const = default;
 };
 
 enum class BulletType {
@@ -81,6 +89,8 @@ struct Bullet {
     BulletType type;
 	double speed;
     Direction direction;
+
+	bool operator==(const Bullet&) const = default;
 };
 
 enum class LaserOrientation {
@@ -91,11 +101,15 @@ enum class LaserOrientation {
 struct Laser {
     int id;
     LaserOrientation orientation;
+
+	bool operator==(const Laser&) const = default;
 };
 
 struct Mine {
     int id;
     std::optional<int> explosionRemainingTicks;
+
+	bool operator==(const Mine&) const = default;
 };
 
 /// ZoneStatus struct to represent various zone states
@@ -104,11 +118,11 @@ struct ZoneStatus {
     /// Used in "beingCaptured" and "beingRetaken"
 	std::optional<int> remainingTicks;
     /// Used in "beingCaptured" and "captured"
-	std::optional<std::string> playerId;
+	std::optional<PlayerId> playerId;
     /// Used in "beingContested" and "beingRetaken"
-	std::optional<std::string> capturedById;
+	std::optional<PlayerId> capturedById;
     /// Used in "beingRetaken"
-	std::optional<std::string> retakenById;
+	std::optional<PlayerId> retakenById;
 };
 
 /// Zone struct to represent a zone on the map
@@ -123,18 +137,32 @@ struct Zone {
 
 // Player struct
 struct Player {
-	std::string id;
-	std::string nickname;
-	uint32_t color;
-	int ping;
+	/// Allocator-aware so the nickname is kept in the memory of its GameState
+	using allocator_type = std::pmr::polymorphic_allocator<>;
+
+	PlayerId id = 0;
+	std::pmr::string nickname;
+	uint32_t color = 0;
+	int ping = 0;
     /// Not present in enemies
 	std::optional<int> score;
     /// Optional because it might be null
 	std::optional<int> ticksToRegen;
-    bool isUsingRadar;
+    bool isUsingRadar = false;
+
+	Player() = default;
+	Player(const Player&) = default;
+	Player(Player&&) = default;
+	Player& operator=(const Player&) = default;
+	Player& operator=(Player&&) = default;
+	explicit Player(const allocator_type& allocator) : nickname(allocator) {}
+	Player(const Player& other, const allocator_type& allocator) : Player(allocator) { *this = other; }
+	Player(Player&& other, const allocator_type& allocator) : Player(allocator) { *this = std::move(other); }
 };
 
-struct Wall {};
+struct Wall {
+	bool operator==(const Wall&) const = default;
+};
 
 enum class ItemType {
     unknown = 0,
@@ -146,35 +174,238 @@ enum class ItemType {
 
 struct Item {
     ItemType type;
+
+	bool operator==(const Item&) const = default;
 };
 
 using TileVariant = std::variant<Wall, Tank, Bullet, Mine, Laser, Item>;
 
-struct Tile {
-    std::vector<TileVariant> objects;
-    bool isVisible;
-    char zoneName; // '?' or 63 for no zone
+/// dim x dim bits in row-major order, bit (x, y) belongs to the tile at
+/// Position(x, y) of the bot, (0, 0) is the top-left corner
+class Bitplane {
+ public:
+	explicit Bitplane(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : words(resource) {}
+
+	/// Sizes the plane for a dim x dim map and clears every bit, keeps the storage
+	void Resize(int dim) {
+		this->dim = dim;
+		words.assign((static_cast<size_t>(dim) * dim + 63) / 64, 0);
+	}
+	int Dim() const { return dim; }
+	bool Test(int x, int y) const {
+		size_t bit = Index(x, y);
+		return (words[bit / 64] >> (bit % 64)) & 1;
+	}
+	void Set(int x, int y) {
+		size_t bit = Index(x, y);
+		words[bit / 64] |= uint64_t{1} << (bit % 64);
+	}
+	void Clear(int x, int y) {
+		size_t bit = Index(x, y);
+		words[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+	}
+	/// Sets every bit on which a and b differ, both planes are sized like this one
+	void SetDifferences(const Bitplane& a, const Bitplane& b) {
+		for (size_t i = 0; i < words.size(); ++i) words[i] |= a.words[i] ^ b.words[i];
+	}
+	/// Calls f(x, y) for every set bit in row-major order, f may clear the bit it is called for
+	template <typename F>
+	void ForEach(F&& f) const {
+		for (size_t i = 0; i < words.size(); ++i) {
+			for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+				size_t bit = i * 64 + std::countr_zero(word);
+				f(static_cast<int>(bit / dim), static_cast<int>(bit % dim));
+			}
+		}
+	}
+	const std::pmr::vector<uint64_t>& Words() const { return words; }
+
+ private:
+	size_t Index(int x, int y) const { return static_cast<size_t>(x) * dim + y; }
+
+	int dim = 0;
+	std::pmr::vector<uint64_t> words;
+};
+
+/// Occupancy layers of a Grid
+enum class GridLayer {
+    wall = 0,
+    tank = 1,
+    bullet = 2,
+    laser = 3,
+    mine = 4,
+    item = 5,
+    visible = 6,
+    count = 7
+};
+
+/// Entry of a Grid side table, the object and the tile it is on
+template <typename T>
+struct GridObject {
+	int x;
+	int y;
+	T object;
+};
+
+/// Flat map of one tick. Every GridLayer is a Bitplane telling which tiles
+/// hold that kind of object, the objects themselves are kept in per-type side
+/// tables in decode order. "Is there a tank here" is a bit test, "which tank"
+/// a scan over the few tanks of the tick. Layers and side tables allocate
+/// from the memory resource the Grid was built with.
+struct Grid {
+	int dim = 0;
+	std::array<Bitplane, static_cast<size_t>(GridLayer::count)> layers;
+	std::pmr::vector<GridObject<Tank>> tanks;
+	std::pmr::vector<GridObject<Bullet>> bullets;
+	std::pmr::vector<GridObject<Laser>> lasers;
+	std::pmr::vector<GridObject<Mine>> mines;
+	std::pmr::vector<GridObject<Item>> items;
+
+	explicit Grid(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: layers(MakeLayers(resource, std::make_index_sequence<static_cast<size_t>(GridLayer::count)>{})),
+		  tanks(resource), bullets(resource), lasers(resource), mines(resource), items(resource) {}
+
+	/// Sizes and clears every layer for a dim x dim map, side tables are kept
+	void Resize(int dim) {
+		this->dim = dim;
+		for (auto& layer : layers) layer.Resize(dim);
+	}
+
+	const Bitplane& Layer(GridLayer layer) const { return layers[static_cast<size_t>(layer)]; }
+	Bitplane& Layer(GridLayer layer) { return layers[static_cast<size_t>(layer)]; }
+	bool Has(GridLayer layer, int x, int y) const { return Layer(layer).Test(x, y); }
+	bool IsVisible(int x, int y) const { return Has(GridLayer::visible, x, y); }
+
+	/// Layer of the objects of type T
+	template <typename T>
+	static constexpr GridLayer LayerOf() {
+		if constexpr (std::is_same_v<T, Tank>) return GridLayer::tank;
+		else if constexpr (std::is_same_v<T, Bullet>) return GridLayer::bullet;
+		else if constexpr (std::is_same_v<T, Laser>) return GridLayer::laser;
+		else if constexpr (std::is_same_v<T, Mine>) return GridLayer::mine;
+		else return GridLayer::item;
+	}
+
+	template <typename T>
+	const std::pmr::vector<GridObject<T>>& Objects() const {
+		if constexpr (std::is_same_v<T, Tank>) return tanks;
+		else if constexpr (std::is_same_v<T, Bullet>) return bullets;
+		else if constexpr (std::is_same_v<T, Laser>) return lasers;
+		else if constexpr (std::is_same_v<T, Mine>) return mines;
+		else return items;
+	}
+
+	template <typename T>
+	std::pmr::vector<GridObject<T>>& Objects() {
+		return const_cast<std::pmr::vector<GridObject<T>>&>(std::as_const(*this).Objects<T>());
+	}
+
+	/// Appends an object to its side table, IndexObjects sets its layer bit
+	template <typename T>
+	void Add(int x, int y, T object) {
+		Objects<T>().push_back(GridObject<T>{x, y, std::move(object)});
+	}
+
+	/// Appends a decoded tile object to its side table, walls belong to StaticMap and are dropped
+	void AddObject(int x, int y, TileVariant object) {
+		std::visit([&](auto& value) {
+			using T = std::decay_t<decltype(value)>;
+			if constexpr (!std::is_same_v<T, Wall>) Add(x, y, std::move(value));
+		}, object);
+	}
+
+	/// Sets the layer bits of every object in the side tables, called once the grid is sized
+	void IndexObjects() {
+		IndexObjects<Tank>();
+		IndexObjects<Bullet>();
+		IndexObjects<Laser>();
+		IndexObjects<Mine>();
+		IndexObjects<Item>();
+	}
+
+	/// True if an object of type T on (x, y) satisfies predicate, empty tiles are rejected by a bit test
+	template <typename T, typename F>
+	bool Any(int x, int y, F&& predicate) const {
+		if (!Has(LayerOf<T>(), x, y)) return false;
+		for (const auto& entry : Objects<T>()) {
+			if (entry.x == x && entry.y == y && predicate(entry.object)) return true;
+		}
+		return false;
+	}
+
+	/// First object of type T on (x, y), nullptr if there is none
+	template <typename T>
+	const T* Find(int x, int y) const {
+		if (!Has(LayerOf<T>(), x, y)) return nullptr;
+		for (const auto& entry : Objects<T>()) {
+			if (entry.x == x && entry.y == y) return &entry.object;
+		}
+		return nullptr;
+	}
+
+ private:
+	/// Layers are not movable between resources, so they are built in place
+	template <size_t... I>
+	static std::array<Bitplane, sizeof...(I)> MakeLayers(std::pmr::memory_resource* resource, std::index_sequence<I...>) {
+		return {((void)I, Bitplane(resource))...};
+	}
+
+	template <typename T>
+	void IndexObjects() {
+		Bitplane& layer = Layer(LayerOf<T>());
+		for (const auto& entry : Objects<T>()) layer.Set(entry.x, entry.y);
+	}
+};
+
+/// Zone geometry, fixed for the whole match
+struct ZoneBounds {
+	int x;
+	int y;
+	int width;
+	int height;
+	char name;
+};
+
+/// Parts of the map that never change during a match: walls and zones.
+/// Built by the parser from the first GameState of a match and shared by every
+/// later tick. Indexed like Grid.
+struct StaticMap {
+	int dim;
+	Bitplane walls;
+	/// Zone name of every tile in row-major order, '?' outside zones
+	std::vector<char> zoneNames;
+	std::vector<ZoneBounds> zones;
+
+	bool IsWall(int x, int y) const { return walls.Test(x, y); }
+	char ZoneName(int x, int y) const { return zoneNames[static_cast<size_t>(x) * dim + y]; }
 };
 
 /// Map struct:
-/// Tiles are stored in a 2D array
-/// Inner array represents columns of the map
-/// Outer arrays represent rows of the map
-/// Item with index [0][0] represents top-left corner of the map
+/// Item with index [0][0] represents top-left corner of the map,
+/// x is the row and y the column like in Position
 struct Map {
-	/// A 2D vector to hold variants of tile objects
-	std::vector<std::vector<Tile>> tiles;
-	std::vector<Zone> zones;
-    /// 2D array of chars ('0' or '1') same as tiles
-	std::vector<std::vector<char>> visibility;
+	/// Objects and visibility of this tick, the wall layer is copied from staticMap
+	Grid grid;
+	std::pmr::vector<Zone> zones;
+	std::shared_ptr<const StaticMap> staticMap;
+
+	explicit Map(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: grid(resource), zones(resource) {}
 };
 
-/// GameState struct
+/// GameState struct, everything it holds is allocated from the memory
+/// resource it was built with, see TickArena
 struct GameState {
     /// tick number
-	int time;
-	std::vector<Player> players;
+	int time = 0;
+	std::pmr::vector<Player> players;
 	Map map;
+
+	explicit GameState(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: players(resource), map(resource) {}
+
+	/// Memory of this tick, scratch data of the bot that dies with the tick can live there too
+	std::pmr::memory_resource* Resource() const { return players.get_allocator().resource(); }
 };
 
 enum class RotationDirection {
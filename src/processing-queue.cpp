@@ -0,0 +1,128 @@
+#include "processing-queue.h"
+
+ProcessingQueue::ProcessingQueue(size_t capacity) : entries(capacity), freeBuffers(MAX_FREE_BUFFERS) {}
+
+void ProcessingQueue::Push(ReceivedFrame frame) {
+	frame.sequence = nextSequence++;
+
+	if (frame.type == PacketType::GameState) {
+		// The slot still holds whatever was swapped out last, keep its storage for the next read
+		std::swap(gameStates[writeSlot], frame);
+		if (frame.bytes.capacity() > 0) spare = std::move(frame.bytes);
+
+		uint8_t previous = latest.exchange(writeSlot | FRESH, std::memory_order_seq_cst);
+		writeSlot = previous & ~FRESH;
+		if (previous & FRESH) droppedGameStates.fetch_add(1, std::memory_order_relaxed);
+	} else if (!entries.TryPush(frame)) {
+		if (droppedFrames.fetch_add(1, std::memory_order_relaxed) == 0) {
+			std::cerr << "Processing queue full, dropping control frames" << std::endl << std::flush;
+		}
+		if (frame.bytes.capacity() > 0) spare = std::move(frame.bytes);
+		return;
+	}
+	processorSignal.Notify();
+}
+
+std::optional<ReceivedFrame> ProcessingQueue::Pop() {
+	while (true) {
+		DrainAndCoalesce();
+		if (!pending.empty()) break;
+		if (closed.load(std::memory_order_seq_cst)) {
+			// Push may have published right before Close
+			DrainAndCoalesce();
+			if (pending.empty()) return std::nullopt;
+			break;
+		}
+		processorSignal.Wait([this]() {
+			return !entries.Empty() || HasFresh() || closed.load(std::memory_order_seq_cst);
+		});
+	}
+
+	ReceivedFrame frame = std::move(pending.front());
+	pending.pop_front();
+	return frame;
+}
+
+void ProcessingQueue::Close() {
+	closed.store(true, std::memory_order_seq_cst);
+	entries.Close();
+	processorSignal.NotifyAll();
+}
+
+size_t ProcessingQueue::DroppedGameStates() const {
+	return droppedGameStates.load(std::memory_order_relaxed);
+}
+
+size_t ProcessingQueue::DroppedFrames() const {
+	return droppedFrames.load(std::memory_order_relaxed);
+}
+
+bool ProcessingQueue::HasFresh() const {
+	return latest.load(std::memory_order_seq_cst) & FRESH;
+}
+
+void ProcessingQueue::DrainAndCoalesce() {
+	// Taken before the ring is drained: every control frame older than it is already in the ring
+	std::optional<ReceivedFrame> gameState;
+	if (HasFresh()) {
+		readSlot = latest.exchange(readSlot, std::memory_order_seq_cst) & ~FRESH;
+		gameState = std::move(gameStates[readSlot]);
+	}
+
+	while (auto entry = entries.TryPop()) {
+		pending.push_back(std::move(*entry));
+	}
+
+	if (gameState) {
+		auto position = std::upper_bound(pending.begin(), pending.end(), gameState->sequence,
+		                                 [](uint64_t sequence, const ReceivedFrame& frame) {
+			                                 return sequence < frame.sequence;
+		                                 });
+		pending.insert(position, std::move(*gameState));
+	}
+
+	// Frames arrive in tick order, so only the last GameState is worth processing
+	auto latestGameState = std::find_if(pending.rbegin(), pending.rend(), [](const ReceivedFrame& frame) {
+		return frame.type == PacketType::GameState;
+	});
+	if (latestGameState == pending.rend()) return;
+
+	size_t keep = std::distance(pending.begin(), latestGameState.base()) - 1;
+	size_t kept = 0;
+	for (size_t i = 0; i < pending.size(); ++i) {
+		if (pending[i].type == PacketType::GameState && i != keep) {
+			Recycle(std::move(pending[i].bytes));
+			droppedGameStates.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+		if (kept != i) pending[kept] = std::move(pending[i]);
+		++kept;
+	}
+	pending.resize(kept);
+}
+
+std::string ProcessingQueue::AcquireBuffer() {
+	if (spare) {
+		std::string buffer = std::move(*spare);
+		spare.reset();
+		buffer.clear();
+		return buffer;
+	}
+	if (auto buffer = freeBuffers.TryPop()) {
+		return std::move(*buffer);
+	}
+
+	std::string buffer;
+	buffer.reserve(frameReserve.load(std::memory_order_relaxed));
+	return buffer;
+}
+
+void ProcessingQueue::Recycle(std::string frame) {
+	frame.clear();
+	frame.reserve(frameReserve.load(std::memory_order_relaxed));
+	freeBuffers.TryPush(frame);
+}
+
+void ProcessingQueue::ReserveFrames(size_t bytes) {
+	frameReserve.store(bytes, std::memory_order_relaxed);
+}
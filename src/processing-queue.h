@@ -0,0 +1,89 @@
+#pragma once
+
+#include "pch.h"
+#include "packet.h"
+#include "spsc-ring.h"
+
+/// Frame handed from the reader to the processing thread
+struct ReceivedFrame {
+	std::string bytes;
+	/// Type read by the reader's pre-classifier, std::nullopt if it could not tell
+	std::optional<PacketType> type;
+	/// Arrival order, stamped by ProcessingQueue::Push
+	uint64_t sequence = 0;
+};
+
+/// Bounded hand-off between the reader and the single processing thread.
+/// The reader never parks in it, since in async mode it runs on the strand
+/// that also drains the outbound lanes.
+///
+/// GameState frames are coalesced on push: they go to a latest-value slot
+/// instead of the ring, and a GameState the processor has not picked up yet is
+/// replaced by the newer one, so the bot always works on the latest tick.
+/// Control packets (GameEnded, LobbyData, warnings, ...) go through the ring
+/// and are handed out in arrival order around the GameState. They are only
+/// dropped if the processor falls a whole ring behind, which without
+/// GameStates in the ring takes a bot stalled for that many control packets.
+///
+/// The queue also keeps a small pool of frame buffers: the reader receives
+/// straight into a recycled std::string and ownership is moved through the
+/// pipeline, so steady-state ticks neither copy nor reallocate frame bytes.
+///
+/// Push/AcquireBuffer belong to the reader, Pop/Recycle/ReserveFrames to the
+/// processing thread.
+class ProcessingQueue {
+ public:
+	explicit ProcessingQueue(size_t capacity = 64);
+
+	/// Never blocks
+	void Push(ReceivedFrame frame);
+	/// Blocks until a frame is available; returns std::nullopt once the queue is closed and drained
+	std::optional<ReceivedFrame> Pop();
+	/// Wakes the processing thread for shutdown, frames already queued are still delivered
+	void Close();
+
+	/// Number of GameState frames discarded because a newer tick arrived
+	size_t DroppedGameStates() const;
+	/// Number of control frames discarded because the ring was full
+	size_t DroppedFrames() const;
+
+	/// Empty buffer for the reader to receive the next frame into
+	std::string AcquireBuffer();
+	/// Returns the storage of a processed frame to the pool
+	void Recycle(std::string frame);
+	/// Capacity pre-reserved for pooled buffers, e.g. the expected GameState size
+	void ReserveFrames(size_t bytes);
+
+ private:
+	static constexpr size_t MAX_FREE_BUFFERS = 4;
+	/// Set in latest while its slot holds a GameState the processor has not taken
+	static constexpr uint8_t FRESH = 4;
+
+	/// Moves everything the reader has published into pending and drops superseded GameStates
+	void DrainAndCoalesce();
+	bool HasFresh() const;
+
+	SpscRing<ReceivedFrame> entries;
+	SpscRing<std::string> freeBuffers;
+	std::atomic<size_t> frameReserve{0};
+
+	/// Triple buffer of the newest GameState: the reader fills its slot and
+	/// swaps it with latest, the processor swaps its own slot with latest
+	std::array<ReceivedFrame, 3> gameStates;
+	std::atomic<uint8_t> latest{1};
+	/// Wakes the processor for both the ring and the slot
+	WakeSignal processorSignal;
+	std::atomic<bool> closed{false};
+	std::atomic<size_t> droppedGameStates{0};
+	std::atomic<size_t> droppedFrames{0};
+
+	// Owned by the reader
+	uint8_t writeSlot = 0;
+	uint64_t nextSequence = 0;
+	/// Storage of a replaced GameState, handed out by the next AcquireBuffer
+	std::optional<std::string> spare;
+
+	// Owned by the processing thread
+	uint8_t readSlot = 2;
+	std::deque<ReceivedFrame> pending;
+};
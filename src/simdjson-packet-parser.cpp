@@ -0,0 +1,441 @@
+#include "simdjson-packet-parser.h"
+#include "json-reader.h"
+#include "game-state-decoder.h"
+
+using simdjson::ondemand::array;
+using simdjson::ondemand::object;
+using simdjson::ondemand::value;
+
+namespace {
+
+int ReadInt(value& json) {
+	int64_t number = json.get_int64();
+	return static_cast<int>(number);
+}
+
+std::string_view ReadString(value& json) {
+	return json.get_string();
+}
+
+std::optional<int> ReadNullableInt(value& json) {
+	if (json.is_null()) return std::nullopt;
+	return ReadInt(json);
+}
+
+std::optional<std::string> ReadNullableString(value& json) {
+	if (json.is_null()) return std::nullopt;
+	return std::string(ReadString(json));
+}
+
+std::optional<PlayerId> ReadNullablePlayer(value& json, PlayerRegistry& players) {
+	if (json.is_null()) return std::nullopt;
+	return players.Intern(ReadString(json));
+}
+
+void DecodePlayer(object player, Player& out, PlayerRegistry& players) {
+	for (auto field : player) {
+		std::string_view key = field.unescaped_key();
+		value json = field.value();
+		switch (KeyHash(key)) {
+			case KeyHash("id"): out.id = players.Intern(ReadString(json)); break;
+			case KeyHash("nickname"): out.nickname = ReadString(json); break;
+			case KeyHash("color"): out.color = static_cast<uint32_t>(int64_t(json.get_int64())); break;
+			case KeyHash("ping"): out.ping = ReadInt(json); break;
+			case KeyHash("score"): out.score = ReadNullableInt(json); break;
+			case KeyHash("ticksToRegen"): out.ticksToRegen = ReadNullableInt(json); break;
+			case KeyHash("isUsingRadar"):
+				if (!json.is_null()) out.isUsingRadar = json.get_bool();
+				break;
+			default: break;
+		}
+	}
+}
+
+void DecodeZone(object zone, Zone& out, PlayerRegistry& players) {
+	for (auto field : zone) {
+		std::string_view key = field.unescaped_key();
+		value json = field.value();
+		switch (KeyHash(key)) {
+			case KeyHash("x"): out.x = ReadInt(json); break;
+			case KeyHash("y"): out.y = ReadInt(json); break;
+			case KeyHash("width"): out.width = ReadInt(json); break;
+			case KeyHash("height"): out.height = ReadInt(json); break;
+			case KeyHash("index"): out.name = static_cast<char>(ReadInt(json)); break;
+			case KeyHash("status"):
+				for (auto statusField : json.get_object()) {
+					std::string_view statusKey = statusField.unescaped_key();
+					value status = statusField.value();
+					switch (KeyHash(statusKey)) {
+						case KeyHash("type"): out.status.type = ReadString(status); break;
+						case KeyHash("remainingTicks"): out.status.remainingTicks = ReadNullableInt(status); break;
+						case KeyHash("playerId"): out.status.playerId = ReadNullablePlayer(status, players); break;
+						case KeyHash("capturedById"): out.status.capturedById = ReadNullablePlayer(status, players); break;
+						case KeyHash("retakenById"): out.status.retakenById = ReadNullablePlayer(status, players); break;
+						default: break;
+					}
+				}
+				break;
+			default: break;
+		}
+	}
+}
+
+Tank DecodeTank(object payload, PlayerRegistry& players) {
+	Tank tank{};
+	bool hasOwnerId = false;
+	bool hasDirection = false;
+	bool hasTurret = false;
+	bool hasTurretDirection = false;
+
+	for (auto field : payload) {
+		std::string_view key = field.unescaped_key();
+		value json = field.value();
+		switch (KeyHash(key)) {
+			case KeyHash("ownerId"):
+				if (json.is_null()) break;
+				tank.ownerId = players.Intern(ReadString(json));
+				hasOwnerId = true;
+				break;
+			case KeyHash("direction"):
+				if (json.is_null()) break;
+				tank.direction = static_cast<Direction>(ReadInt(json));
+				hasDirection = true;
+				break;
+			case KeyHash("turret"):
+				if (json.is_null()) break;
+				hasTurret = true;
+				for (auto turretField : json.get_object()) {
+					std::string_view turretKey = turretField.unescaped_key();
+					value turret = turretField.value();
+					switch (KeyHash(turretKey)) {
+						case KeyHash("direction"):
+							if (turret.is_null()) break;
+							tank.turret.direction = static_cast<Direction>(ReadInt(turret));
+							hasTurretDirection = true;
+							break;
+						case KeyHash("bulletCount"): tank.turret.bulletCount = ReadNullableInt(turret); break;
+						case KeyHash("ticksToRegenBullet"): tank.turret.ticksToRegenBullet = ReadNullableInt(turret); break;
+						default: break;
+					}
+				}
+				break;
+			case KeyHash("health"): tank.health = ReadNullableInt(json); break;
+			case KeyHash("secondaryItem"):
+				if (json.is_null()) break;
+				tank.secondaryItem = static_cast<SecondaryItemType>(ReadInt(json));
+				break;
+			default: break;
+		}
+	}
+
+	if (!hasOwnerId) throw std::runtime_error("Missing or null ownerId in tank payload.");
+	if (!hasDirection) throw std::runtime_error("Missing or null direction in tank payload.");
+	if (!hasTurret) throw std::runtime_error("Missing turret in tank payload.");
+	if (!hasTurretDirection) throw std::runtime_error("Missing or null turret direction.");
+	return tank;
+}
+
+std::optional<TileVariant> DecodeTileObjectPayload(value& payload, uint32_t type, PlayerRegistry& players) {
+	switch (type) {
+		case KeyHash("tank"):
+			return DecodeTank(payload.get_object(), players);
+		case KeyHash("bullet"): {
+			Bullet bullet{};
+			for (auto field : payload.get_object()) {
+				std::string_view key = field.unescaped_key();
+				value json = field.value();
+				switch (KeyHash(key)) {
+					case KeyHash("id"): bullet.id = ReadInt(json); break;
+					case KeyHash("speed"): bullet.speed = json.get_double(); break;
+					case KeyHash("direction"): bullet.direction = static_cast<Direction>(ReadInt(json)); break;
+					case KeyHash("type"): bullet.type = static_cast<BulletType>(ReadInt(json)); break;
+					default: break;
+				}
+			}
+			return bullet;
+		}
+		case KeyHash("item"): {
+			Item item{};
+			for (auto field : payload.get_object()) {
+				std::string_view key = field.unescaped_key();
+				if (KeyHash(key) != KeyHash("type")) continue;
+				value json = field.value();
+				item.type = static_cast<ItemType>(ReadInt(json));
+			}
+			return item;
+		}
+		case KeyHash("laser"): {
+			Laser laser{};
+			for (auto field : payload.get_object()) {
+				std::string_view key = field.unescaped_key();
+				value json = field.value();
+				switch (KeyHash(key)) {
+					case KeyHash("id"): laser.id = ReadInt(json); break;
+					case KeyHash("orientation"): laser.orientation = static_cast<LaserOrientation>(ReadInt(json)); break;
+					default: break;
+				}
+			}
+			return laser;
+		}
+		case KeyHash("mine"): {
+			Mine mine{};
+			for (auto field : payload.get_object()) {
+				std::string_view key = field.unescaped_key();
+				value json = field.value();
+				switch (KeyHash(key)) {
+					case KeyHash("id"): mine.id = ReadInt(json); break;
+					case KeyHash("explosionRemainingTicks"): mine.explosionRemainingTicks = ReadNullableInt(json); break;
+					default: break;
+				}
+			}
+			return mine;
+		}
+		default:
+			return std::nullopt;
+	}
+}
+
+/// Decodes one object on tile (x, y) into the grid. Walls are static and never
+/// stored, returns true if the object was one.
+bool DecodeTileObject(object tileObject, Grid& grid, int x, int y, PlayerRegistry& players) {
+	std::optional<uint32_t> type;
+	bool empty = true;
+	bool decoded = false;
+	bool payloadBeforeType = false;
+
+	for (auto field : tileObject) {
+		empty = false;
+		std::string_view key = field.unescaped_key();
+		value json = field.value();
+		switch (KeyHash(key)) {
+			case KeyHash("type"):
+				type = KeyHash(ReadString(json));
+				break;
+			case KeyHash("payload"):
+				if (!type) {
+					payloadBeforeType = true;
+				} else if (*type != KeyHash("wall")) {
+					if (auto object = DecodeTileObjectPayload(json, *type, players)) grid.AddObject(x, y, std::move(*object));
+				}
+				decoded = type.has_value();
+				break;
+			default: break;
+		}
+	}
+
+	// Empty objects carry nothing
+	if (empty) return false;
+	if (!type) throw std::runtime_error("Missing type in tile object.");
+	if (*type == KeyHash("wall")) return true;
+	if (decoded) return false;
+	if (!payloadBeforeType) throw std::runtime_error("Missing payload in tile object.");
+
+	// Come back to the payload now that the type is known
+	if (tileObject.reset().error() != simdjson::SUCCESS) throw std::runtime_error("Malformed tile object.");
+	value payload = tileObject.find_field_unordered("payload");
+	if (auto object = DecodeTileObjectPayload(payload, *type, players)) grid.AddObject(x, y, std::move(*object));
+	return false;
+}
+
+}
+
+simdjson::ondemand::document SimdjsonPacketParser::Iterate(const std::string& frame) {
+	if (frame.capacity() - frame.size() >= FRAME_PADDING) {
+		return parser.iterate(simdjson::padded_string_view(frame));
+	}
+	paddedFrame.reserve(frame.size() + FRAME_PADDING);
+	paddedFrame.assign(frame);
+	return parser.iterate(simdjson::padded_string_view(paddedFrame));
+}
+
+PacketType SimdjsonPacketParser::ParseType(const std::string& frame) {
+	auto document = Iterate(frame);
+	uint64_t type = document["type"].get_uint64();
+	return static_cast<PacketType>(type);
+}
+
+GameStateView& SimdjsonPacketParser::ViewGameState(const std::string& frame) {
+	// The view needs no padding, it reads with JsonReader
+	gameStateView.Reset(frame);
+	return gameStateView;
+}
+
+void SimdjsonPacketParser::ParseGameState(const std::string& frame, GameState& gameState, std::string& id) {
+	auto document = Iterate(frame);
+	object payload = document["payload"].get_object();
+
+	for (auto field : payload) {
+		std::string_view key = field.unescaped_key();
+		value json = field.value();
+		switch (KeyHash(key)) {
+			case KeyHash("id"):
+				id = ReadString(json);
+				break;
+			case KeyHash("tick"):
+				gameState.time = ReadInt(json);
+				break;
+			case KeyHash("players"):
+				for (auto playerJson : json.get_array()) {
+					// Built in place so the nickname lands in the memory of gameState
+					DecodePlayer(playerJson.get_object(), gameState.players.emplace_back(), players);
+				}
+				break;
+			case KeyHash("map"):
+				for (auto mapField : json.get_object()) {
+					std::string_view mapKey = mapField.unescaped_key();
+					value mapJson = mapField.value();
+					switch (KeyHash(mapKey)) {
+						case KeyHash("zones"):
+							for (auto zoneJson : mapJson.get_array()) {
+								Zone zone{};
+								DecodeZone(zoneJson.get_object(), zone, players);
+								gameState.map.zones.push_back(std::move(zone));
+							}
+							break;
+						case KeyHash("visibility"): {
+							// Rows of '0'/'1' characters
+							int x = 0;
+							for (auto rowJson : mapJson.get_array()) {
+								GameStateDecoder::ApplyVisibilityRow(gameState.map.grid, x++, rowJson.get_string());
+							}
+							break;
+						}
+						case KeyHash("tiles"):
+							DecodeTiles(mapJson, gameState.map.grid);
+							break;
+						default: break;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	gameState.map.grid.IndexObjects();
+	staticMapCache.Finish(gameState.map);
+}
+
+void SimdjsonPacketParser::DecodeTiles(value& json, Grid& grid) {
+	// Decoded in the server's layer order, layer[i][j] is Grid tile (j, i)
+	bool recordWalls = !staticMapCache.Get();
+	if (parallelTiles.Enabled()) {
+		// The threads read the raw text of the tiles, it lives in the frame
+		JsonReader reader(std::string_view(json.raw_json()));
+		parallelTiles.Decode(reader, grid, players, recordWalls ? &staticMapCache : nullptr);
+		return;
+	}
+
+	int i = 0;
+	int cells = 0;
+	for (auto layerRow : json.get_array()) {
+		int j = 0;
+		for (auto cell : layerRow.get_array()) {
+			bool wall = false;
+			for (auto tileObject : cell.get_array()) wall |= DecodeTileObject(tileObject.get_object(), grid, j, i, players);
+
+			// First frame of the match, StaticMapCache::Finish builds the wall layer
+			if (wall && recordWalls) staticMapCache.RecordWall(j, i);
+			++j;
+		}
+		cells = std::max(cells, j);
+		++i;
+	}
+
+	GameStateDecoder::SizeGrid(grid, std::max(i, cells));
+}
+
+LobbyData SimdjsonPacketParser::ParseLobbyData(const std::string& frame) {
+	staticMapCache.Reset();
+	players.Reset();
+
+	auto document = Iterate(frame);
+	object payload = document["payload"].get_object();
+	LobbyData lobbyData{};
+	std::string myId;
+
+	for (auto field : payload) {
+		std::string_view key = field.unescaped_key();
+		value json = field.value();
+		switch (KeyHash(key)) {
+			case KeyHash("playerId"):
+				myId = ReadString(json);
+				break;
+			case KeyHash("players"):
+				for (auto playerJson : json.get_array()) {
+					LobbyPlayer lobbyPlayer{};
+					for (auto playerField : playerJson.get_object()) {
+						std::string_view playerKey = playerField.unescaped_key();
+						value player = playerField.value();
+						switch (KeyHash(playerKey)) {
+							case KeyHash("id"): lobbyPlayer.id = ReadString(player); break;
+							case KeyHash("nickname"): lobbyPlayer.nickname = ReadString(player); break;
+							case KeyHash("color"): lobbyPlayer.color = static_cast<uint32_t>(int64_t(player.get_int64())); break;
+							default: break;
+						}
+					}
+					players.Intern(lobbyPlayer.id);
+					lobbyData.players.push_back(std::move(lobbyPlayer));
+				}
+				break;
+			case KeyHash("serverSettings"):
+				for (auto settingsField : json.get_object()) {
+					std::string_view settingsKey = settingsField.unescaped_key();
+					value setting = settingsField.value();
+					switch (KeyHash(settingsKey)) {
+						case KeyHash("matchName"): lobbyData.matchName = ReadNullableString(setting); break;
+						case KeyHash("sandboxMode"): lobbyData.sandboxMode = setting.get_bool(); break;
+						case KeyHash("gridDimension"): lobbyData.gridDimension = ReadInt(setting); break;
+						case KeyHash("numberOfPlayers"): lobbyData.numberOfPlayers = ReadInt(setting); break;
+						case KeyHash("seed"): lobbyData.seed = ReadInt(setting); break;
+						case KeyHash("broadcastInterval"): lobbyData.broadcastInterval = ReadInt(setting); break;
+						case KeyHash("eagerBroadcast"): lobbyData.eagerBroadcast = setting.get_bool(); break;
+						case KeyHash("version"): lobbyData.version = ReadString(setting); break;
+						default: break;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	parallelTiles.StartMatch(lobbyData.gridDimension);
+
+	// After the players, so lobby players keep their indices as handles
+	lobbyData.myId = players.Intern(myId);
+	return lobbyData;
+}
+
+EndGameLobby SimdjsonPacketParser::ParseGameEnded(const std::string& frame) {
+	auto document = Iterate(frame);
+	EndGameLobby endGameLobby;
+
+	for (auto playerJson : document["payload"]["players"].get_array()) {
+		EndGamePlayer lobbyPlayer{};
+		for (auto field : playerJson.get_object()) {
+			std::string_view key = field.unescaped_key();
+			value json = field.value();
+			switch (KeyHash(key)) {
+				case KeyHash("id"): lobbyPlayer.id = ReadString(json); break;
+				case KeyHash("nickname"): lobbyPlayer.nickname = ReadString(json); break;
+				case KeyHash("color"): lobbyPlayer.color = static_cast<uint32_t>(int64_t(json.get_int64())); break;
+				case KeyHash("score"): lobbyPlayer.score = ReadInt(json); break;
+				default: break;
+			}
+		}
+		endGameLobby.players.push_back(std::move(lobbyPlayer));
+	}
+
+	return endGameLobby;
+}
+
+std::optional<std::string> SimdjsonPacketParser::ParsePayloadString(const std::string& frame, std::string_view key) {
+	auto document = Iterate(frame);
+	value payload;
+	if (document["payload"].get(payload) != simdjson::SUCCESS) return std::nullopt;
+
+	value json;
+	if (payload.find_field_unordered(key).get(json) != simdjson::SUCCESS) return std::nullopt;
+	return ReadNullableString(json);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "pch.h"
+#include "packet.h"
+#include "processed-packets.h"
+#include "static-map-cache.h"
+#include "player-registry.h"
+#include "parallel-tile-decoder.h"
+#include "game-state-view.h"
+#include <simdjson.h>
+
+/// simdjson on-demand backend. Frames are parsed in place when the receive
+/// buffer has SIMDJSON_PADDING spare bytes of capacity, otherwise they are
+/// first copied into a padded scratch buffer. Tiles of large grids are
+/// decoded from their raw text by a ParallelTileDecoder.
+class SimdjsonPacketParser {
+ public:
+	/// Bytes past the end of a frame the parser may read
+	static constexpr size_t FRAME_PADDING = simdjson::SIMDJSON_PADDING;
+
+	/// Only needed for frames the reader could not classify
+	PacketType ParseType(const std::string& frame);
+	void ParseGameState(const std::string& frame, GameState& gameState, std::string& id);
+	/// Lazy view of a GameState frame, reused for every frame, see GameStateView
+	GameStateView& ViewGameState(const std::string& frame);
+	LobbyData ParseLobbyData(const std::string& frame);
+	EndGameLobby ParseGameEnded(const std::string& frame);
+	/// String member of the payload, std::nullopt if missing or null
+	std::optional<std::string> ParsePayloadString(const std::string& frame, std::string_view key);
+
+ private:
+	simdjson::ondemand::document Iterate(const std::string& frame);
+	void DecodeTiles(simdjson::ondemand::value& json, Grid& grid);
+
+	simdjson::ondemand::parser parser;
+	std::string paddedFrame;
+	StaticMapCache staticMapCache;
+	PlayerRegistry players;
+	ParallelTileDecoder parallelTiles;
+	GameStateView gameStateView{players, staticMapCache};
+};
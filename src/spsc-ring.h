@@ -0,0 +1,124 @@
+#pragma once
+
+#include "pch.h"
+
+/// Futex-backed wakeup for a single parked thread. Notify() is a couple of
+/// atomic loads unless the waiter is actually parked.
+class WakeSignal {
+ public:
+	/// Parks until ready() holds. The parked flag and the re-check of ready() form
+	/// a Dekker pair with the notifier's publish-then-Notify(), so a wakeup cannot
+	/// be lost between the check and the wait.
+	template<class Ready>
+	void Wait(Ready&& ready) {
+		uint32_t seen = sequence.load(std::memory_order_seq_cst);
+		parked.store(true, std::memory_order_seq_cst);
+		if (!ready()) {
+			sequence.wait(seen, std::memory_order_seq_cst);
+		}
+		parked.store(false, std::memory_order_relaxed);
+	}
+
+	void Notify() {
+		if (parked.load(std::memory_order_seq_cst)) NotifyAll();
+	}
+
+	void NotifyAll() {
+		sequence.fetch_add(1, std::memory_order_seq_cst);
+		sequence.notify_all();
+	}
+
+ private:
+	std::atomic<uint32_t> sequence{0};
+	std::atomic<bool> parked{false};
+};
+
+/// Bounded lock-free single-producer/single-consumer ring.
+///
+/// Exactly one thread may push and exactly one (other) thread may pop. The
+/// non-blocking TryPush/TryPop never touch a syscall; the blocking Push/Pop
+/// spin briefly and then park on a WakeSignal, and the other side only pays
+/// for a notify when its peer is actually parked.
+template<class T>
+class SpscRing {
+ public:
+	explicit SpscRing(size_t capacity) : mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+	                                     slots(std::make_unique<T[]>(mask + 1)) {}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	/// Producer side, moves from value only on success
+	bool TryPush(T& value) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) > mask) return false;
+
+		slots[t & mask] = std::move(value);
+		tail.store(t + 1, std::memory_order_seq_cst);
+		consumerSignal.Notify();
+		return true;
+	}
+
+	/// Consumer side
+	std::optional<T> TryPop() {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return std::nullopt;
+
+		std::optional<T> value(std::move(slots[h & mask]));
+		head.store(h + 1, std::memory_order_seq_cst);
+		producerSignal.Notify();
+		return value;
+	}
+
+	/// Blocks while the ring is full, returns false if the ring was closed
+	bool Push(T value) {
+		for (int spin = 0;; ++spin) {
+			if (closed.load(std::memory_order_acquire)) return false;
+			if (TryPush(value)) return true;
+			if (spin < SPIN_ITERATIONS) {
+				std::this_thread::yield();
+				continue;
+			}
+			producerSignal.Wait([this]() { return !Full() || closed.load(std::memory_order_seq_cst); });
+		}
+	}
+
+	/// Blocks while the ring is empty, returns std::nullopt once closed and drained
+	std::optional<T> Pop() {
+		for (int spin = 0;; ++spin) {
+			if (auto value = TryPop()) return value;
+			if (closed.load(std::memory_order_acquire)) return TryPop();
+			if (spin < SPIN_ITERATIONS) {
+				std::this_thread::yield();
+				continue;
+			}
+			consumerSignal.Wait([this]() { return !Empty() || closed.load(std::memory_order_seq_cst); });
+		}
+	}
+
+	/// Wakes both sides; pushes fail afterwards, pops drain what is left
+	void Close() {
+		closed.store(true, std::memory_order_seq_cst);
+		consumerSignal.NotifyAll();
+		producerSignal.NotifyAll();
+	}
+
+	bool Empty() const {
+		return head.load(std::memory_order_seq_cst) == tail.load(std::memory_order_seq_cst);
+	}
+
+	bool Full() const {
+		return tail.load(std::memory_order_seq_cst) - head.load(std::memory_order_seq_cst) > mask;
+	}
+
+ private:
+	static constexpr int SPIN_ITERATIONS = 64;
+
+	alignas(64) std::atomic<size_t> head{0};
+	alignas(64) std::atomic<size_t> tail{0};
+	alignas(64) WakeSignal consumerSignal;
+	alignas(64) WakeSignal producerSignal;
+	std::atomic<bool> closed{false};
+	size_t mask;
+	std::unique_ptr<T[]> slots;
+};
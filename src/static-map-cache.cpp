@@ -0,0 +1,48 @@
+#include "static-map-cache.h"
+
+void StaticMapCache::Reset() {
+	staticMap.reset();
+	walls.clear();
+}
+
+void StaticMapCache::RecordWall(int x, int y) {
+	walls.emplace_back(x, y);
+}
+
+void StaticMapCache::MergeWalls(StaticMapCache& other) {
+	walls.insert(walls.end(), other.walls.begin(), other.walls.end());
+	other.walls.clear();
+}
+
+void StaticMapCache::Finish(Map& map) {
+	if (staticMap && staticMap->dim != map.grid.dim) {
+		// Walls of this frame were skipped, the next one rebuilds the layer
+		Reset();
+		throw std::runtime_error("GameState grid does not match the cached static map.");
+	}
+
+	if (!staticMap) {
+		auto built = std::make_shared<StaticMap>();
+		built->dim = map.grid.dim;
+		built->walls.Resize(built->dim);
+		built->zoneNames.assign(static_cast<size_t>(built->dim) * built->dim, '?');
+		for (auto [x, y] : walls) built->walls.Set(x, y);
+		walls.clear();
+
+		// Earlier zones win where they overlap, like the per-tile zone test did
+		for (const auto& zone : map.zones) {
+			built->zones.push_back(ZoneBounds{zone.x, zone.y, zone.width, zone.height, zone.name});
+			for (int row = std::max(zone.y, 0); row < std::min(zone.y + zone.height, built->dim); ++row) {
+				for (int col = std::max(zone.x, 0); col < std::min(zone.x + zone.width, built->dim); ++col) {
+					char& name = built->zoneNames[static_cast<size_t>(row) * built->dim + col];
+					if (name == '?') name = zone.name;
+				}
+			}
+		}
+
+		staticMap = std::move(built);
+	}
+
+	map.staticMap = staticMap;
+	map.grid.Layer(GridLayer::wall) = staticMap->walls;
+}
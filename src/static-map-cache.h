@@ -0,0 +1,29 @@
+#pragma once
+
+#include "pch.h"
+#include "processed-packets.h"
+
+/// Per-match StaticMap kept by a packet parser. The first GameState of a match
+/// is decoded in full: the parser reports its walls with RecordWall and Finish
+/// builds the static layer from them and the zones. Later frames skip walls
+/// and only decode what moves.
+class StaticMapCache {
+ public:
+	/// Static layer of the current match, nullptr until the first GameState is complete
+	const StaticMap* Get() const { return staticMap.get(); }
+	/// Starts a new match, the next GameState builds a new static layer
+	void Reset();
+	/// Reports a wall on Grid tile (x, y) while Get() is nullptr
+	void RecordWall(int x, int y);
+	/// Moves the walls recorded by other, e.g. for a run of layers decoded on another thread
+	void MergeWalls(StaticMapCache& other);
+	/// Called once a GameState is decoded and its grid sized. On the first frame
+	/// of a match builds the static layer, then attaches it to the map and
+	/// copies its walls into the grid's wall layer.
+	void Finish(Map& map);
+
+ private:
+	std::shared_ptr<const StaticMap> staticMap;
+	/// Walls of the frame being decoded, in Grid coordinates
+	std::vector<std::pair<int, int>> walls;
+};
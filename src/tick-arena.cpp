@@ -0,0 +1,37 @@
+#include "tick-arena.h"
+
+size_t TickArena::BytesForGrid(int dim) {
+	// Bit layers and side tables of the GameState and the bot's per-tick scratch, under 3 bytes
+	// a tile on recorded 24x24 to 128x128 games; bfs keeps its state in SearchWorkspace instead
+	size_t tiles = static_cast<size_t>(dim) * dim;
+	return (16 << 10) + tiles * 8;
+}
+
+TickArena::TickArena(size_t bytes) {
+	Reserve(bytes);
+}
+
+void TickArena::Reserve(size_t bytes) {
+	resource.reset();
+	buffer = std::make_unique<std::byte[]>(bytes);
+	capacity = bytes;
+	overflow.bytes = 0;
+	resource.emplace(buffer.get(), capacity, &overflow);
+}
+
+void TickArena::Reset() {
+	resource->release();
+	if (overflow.bytes > 0) {
+		// Only happens while warming up, the buffer settles at the largest tick seen
+		Reserve(capacity + overflow.bytes);
+	}
+}
+
+void* TickArena::OverflowResource::do_allocate(size_t size, size_t alignment) {
+	bytes += size;
+	return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void TickArena::OverflowResource::do_deallocate(void* pointer, size_t size, size_t alignment) {
+	std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+}
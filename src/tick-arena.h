@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pch.h"
+
+/// Memory for everything that lives for a single tick: the GameState and the
+/// scratch buffers the bot builds from it. Allocations bump a pointer through
+/// one preallocated buffer and Reset rewinds it in O(1), so steady-state ticks
+/// never reach the global allocator. A tick that outgrows the buffer is served
+/// from the heap and the next Reset enlarges the buffer to fit it.
+class TickArena {
+ public:
+	/// Rough size of one tick on a dim x dim grid
+	static size_t BytesForGrid(int dim);
+
+	explicit TickArena(size_t bytes = BytesForGrid(0));
+	/// Replaces the buffer with one of at least bytes, nothing may be allocated from it
+	void Reserve(size_t bytes);
+	/// Releases everything allocated since the last Reset, objects built on it must be gone
+	void Reset();
+	std::pmr::memory_resource* Resource() { return &*resource; }
+	size_t Capacity() const { return capacity; }
+
+ private:
+	/// Heap fallback of the buffer, remembers how much it handed out
+	class OverflowResource : public std::pmr::memory_resource {
+	 public:
+		size_t bytes = 0;
+
+	 private:
+		void* do_allocate(size_t size, size_t alignment) override;
+		void do_deallocate(void* pointer, size_t size, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+	};
+
+	std::unique_ptr<std::byte[]> buffer;
+	size_t capacity = 0;
+	OverflowResource overflow;
+	std::optional<std::pmr::monotonic_buffer_resource> resource;
+};
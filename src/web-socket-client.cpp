@@ -2,15 +2,29 @@
 
 #include <utility>
 #include "packet.h"
+#include "frame-classifier.h"
 
 boost::asio::io_context WebSocketClient::ioc;
 boost::asio::ip::tcp::socket WebSocketClient::socket(WebSocketClient::ioc);
 boost::beast::websocket::stream<boost::asio::ip::tcp::socket> WebSocketClient::ws(std::move(WebSocketClient::socket));
 std::thread WebSocketClient::workThread;
+#ifdef ASYNC_TRANSPORT
+boost::asio::strand<boost::asio::io_context::executor_type> WebSocketClient::strand(boost::asio::make_strand(WebSocketClient::ioc));
+bool WebSocketClient::writing = false;
+bool WebSocketClient::closing = false;
+#endif
 
 WebSocketClient::WebSocketClient(std::string  host, std::string  port, std::string nickname, std::string  code)
 	: host(std::move(host)), port(std::move(port)), nickname(std::move(nickname)), code(std::move(code)),
-	  handler(&bot, &messagesToSend, &mtx, &cv) {}
+#ifdef ASYNC_TRANSPORT
+	  sender(messagesToSend, [this]() { ScheduleWrite(); }),
+	  handler(&bot, &parser, sender),
+	  resolver(strand)
+#else
+	  sender(messagesToSend),
+	  handler(&bot, &parser, sender)
+#endif
+{}
 
 WebSocketClient::~WebSocketClient()
 {
@@ -20,6 +34,13 @@ WebSocketClient::~WebSocketClient()
 
 void WebSocketClient::Stop()
 {
+#ifdef ASYNC_TRANSPORT
+	// Let queued writes (e.g. the last action) reach the socket, then close on the strand
+	boost::asio::post(strand, []() {
+		closing = true;
+		if (!writing) DoClose();
+	});
+#else
 	try {
 		// Close the WebSocket connection
 		if (ws.is_open()) {
@@ -37,6 +58,7 @@ void WebSocketClient::Stop()
 	#else
 		#error "Unsupported platform"
 	#endif
+#endif
 }
 
 std::string WebSocketClient::ConstructUrl()
@@ -64,12 +86,67 @@ std::future<bool> WebSocketClient::Connect()
 	return future;
 }
 
+#ifdef ASYNC_TRANSPORT
+void WebSocketClient::DoConnect()
+{
+	resolver.async_resolve(host, port, [this](boost::beast::error_code ec, boost::asio::ip::tcp::resolver::results_type results) {
+		OnResolve(ec, std::move(results));
+	});
+
+	// Drives the whole connection until the socket is closed
+	Run();
+}
+
+void WebSocketClient::OnResolve(boost::beast::error_code ec, boost::asio::ip::tcp::resolver::results_type results)
+{
+	if (ec) {
+		std::cerr << "Resolve error: " << ec.message() << std::endl << std::flush;
+		connectPromise.set_value(false);
+		return;
+	}
+
+	boost::asio::async_connect(ws.next_layer(), results, boost::asio::bind_executor(strand,
+		[this](boost::beast::error_code ec, const boost::asio::ip::tcp::endpoint&) {
+			OnConnect(ec);
+		}));
+}
+
+void WebSocketClient::OnConnect(boost::beast::error_code ec)
+{
+	if (ec) {
+		std::cerr << "Connect error: " << ec.message() << std::endl << std::flush;
+		connectPromise.set_value(false);
+		return;
+	}
+
+	// Actions are tiny and latency bound, do not let Nagle hold them back
+	ws.next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+
+	ws.async_handshake(host, ConstructUrl(), boost::asio::bind_executor(strand, [this](boost::beast::error_code ec) {
+		OnHandshake(ec);
+	}));
+}
+
+void WebSocketClient::OnHandshake(boost::beast::error_code ec)
+{
+	if (ec) {
+		std::cerr << "Handshake error: " << ec.message() << std::endl << std::flush;
+		connectPromise.set_value(false);
+		return;
+	}
+
+	connectPromise.set_value(true);
+	readFrame = messagesReceived.AcquireBuffer();
+	DoAsyncRead();
+}
+#else
 void WebSocketClient::DoConnect()
 {
 	try {
 		boost::asio::ip::tcp::resolver resolver(ioc);
 		auto const results = resolver.resolve(host, port);
 		boost::asio::connect(ws.next_layer(), results.begin(), results.end());
+		ws.next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
 
 		std::string path = ConstructUrl();
 		ws.handshake(host, path);
@@ -81,6 +158,7 @@ void WebSocketClient::DoConnect()
         connectPromise.set_value(false);
 	}
 }
+#endif
 
 void WebSocketClient::SignalHandler(int signal) {
     std::cout << "\nCtrl+C was pressed! Signal (" << signal << ") received.\n";
@@ -97,12 +175,16 @@ void WebSocketClient::SignalHandler(int signal) {
 
 void WebSocketClient::Run()
 {
-	ioc.run();
-
 	std::thread processingThread([this]() {
-	  SendToProcessing();
+	  ProcessingLoop();
 	});
 
+#ifdef ASYNC_TRANSPORT
+	// Reads and writes are completion handlers on the strand, run() returns once the socket is closed
+	ioc.run();
+	messagesReceived.Close();
+	processingThread.join();
+#else
 	std::thread readThread([this]() {
 	  DoRead();
 	});
@@ -114,19 +196,94 @@ void WebSocketClient::Run()
 	processingThread.join();
 	readThread.join();
 	writeThread.join();
+#endif
 }
 
+#ifdef ASYNC_TRANSPORT
+void WebSocketClient::DoAsyncRead()
+{
+	readBuffer.emplace(readFrame);
+	ws.async_read(*readBuffer, boost::asio::bind_executor(strand, [this](boost::beast::error_code ec, std::size_t bytesTransferred) {
+		OnRead(ec, bytesTransferred);
+	}));
+}
+
+void WebSocketClient::OnRead(boost::beast::error_code ec, std::size_t bytesTransferred)
+{
+	if (ec) {
+		if (ec != boost::beast::websocket::error::closed && ec != boost::asio::error::operation_aborted) {
+			std::cerr << "Read error: " << ec.message() << std::endl << std::flush;
+		}
+		return;
+	}
+
+	DispatchFrame(readFrame);
+	DoAsyncRead();
+}
+
+void WebSocketClient::ScheduleWrite()
+{
+	// Only one drain is in flight, further pushes are picked up by it
+	if (!writeScheduled.exchange(true)) {
+		boost::asio::post(strand, [this]() { DoAsyncWrite(); });
+	}
+}
+
+void WebSocketClient::DoAsyncWrite()
+{
+	if (writing) return;
+
+	auto message = messagesToSend.TryPop();
+	if (!message) {
+		writeScheduled.store(false);
+		// A push that raced with the store above saw writeScheduled set and did not post
+		if (messagesToSend.Empty() || writeScheduled.exchange(true)) {
+			if (closing) DoClose();
+			return;
+		}
+		message = messagesToSend.TryPop();
+	}
+	if (!ws.is_open()) return;
+
+	currentWrite = *message;
+	writing = true;
+	ws.async_write(boost::asio::buffer(currentWrite.Data(), currentWrite.Size()), boost::asio::bind_executor(strand,
+		[this](boost::beast::error_code ec, std::size_t bytesTransferred) {
+			OnWrite(ec, bytesTransferred);
+		}));
+}
+
+void WebSocketClient::OnWrite(boost::beast::error_code ec, std::size_t bytesTransferred)
+{
+	writing = false;
+	if (ec) {
+		std::cerr << "Write error: " << ec.message() << std::endl << std::flush;
+		return;
+	}
+
+	DoAsyncWrite();
+}
+
+void WebSocketClient::DoClose()
+{
+	if (!ws.is_open()) return;
+	ws.async_close(boost::beast::websocket::close_code::normal, boost::asio::bind_executor(strand, [](boost::beast::error_code ec) {
+		if (ec) {
+			std::cerr << "Error closing WebSocket: " << ec.message() << std::endl << std::flush;
+		}
+	}));
+}
+
+#else
 void WebSocketClient::DoRead()
 {
 	try {
+		// Receive straight into a pooled string, no intermediate flat_buffer copy
+		std::string frame = messagesReceived.AcquireBuffer();
 		while (true) {
-			boost::beast::flat_buffer buffer;
+			auto buffer = boost::asio::dynamic_buffer(frame);
 			ws.read(buffer);
-			std::string message = boost::beast::buffers_to_string(buffer.data());
-
-			std::lock_guard<std::mutex> lock(mtxR);
-			messagesReceived.push(message);
-			cvR.notify_one();
+			DispatchFrame(frame);
 		}
 	} catch (boost::beast::error_code& e) {
 		std::cerr << "Read error: " << e.message() << std::endl << std::flush;
@@ -139,69 +296,64 @@ void WebSocketClient::DoRead()
 	}
 }
 
-void WebSocketClient::SendToProcessing()
+void WebSocketClient::DoWrite()
 {
 	try {
-		while (true) {
-			std::unique_lock<std::mutex> lock(mtxR);
-			cvR.wait(lock, [this]() { return !messagesReceived.empty(); });
-
-			while (!messagesReceived.empty()) {
-				std::string message = messagesReceived.front();
-				messagesReceived.pop();
-				lock.unlock();
-
-				std::thread processMessageThread([this, message]() {
-				  ProcessMessage(message);
-				});
-
-				processMessageThread.detach();
-
-				lock.lock();
-			}
+		// Parks on the scheduler when idle, no mutex is shared with the producers
+		while (auto message = messagesToSend.Pop()) {
+			ws.write(boost::asio::buffer(message->Data(), message->Size()));
 		}
+	} catch (boost::beast::error_code& e) {
+		std::cerr << "Write error: " << e.message() << std::endl << std::flush;
 	} catch (std::exception& e) {
-		std::cerr << "Send to processing exception: " << e.what() << std::endl << std::flush;
+		std::cerr << "Write exception: " << e.what() << std::endl << std::flush;
+		Stop();
 	}
 }
+#endif
 
-void WebSocketClient::DoWrite()
+void WebSocketClient::DispatchFrame(std::string& frame)
+{
+	auto type = PeekPacketType(frame);
+
+	// Ping never waits behind the bot, and neither Ping nor Pong needs a JSON DOM
+	if (type == PacketType::Ping || type == PacketType::Pong) {
+		if (type == PacketType::Ping) RespondToPing();
+		frame.clear();
+		return;
+	}
+
+	messagesReceived.Push({std::move(frame), type});
+	frame = messagesReceived.AcquireBuffer();
+}
+
+void WebSocketClient::ProcessingLoop()
 {
+	// Single long-lived consumer: the bot never runs concurrently with itself
 	try {
 		while (true) {
-			std::unique_lock<std::mutex> lock(mtx);
-			cv.wait(lock, [this]() { return !messagesToSend.empty(); });
-
-			while (!messagesToSend.empty()) {
-				std::string message = messagesToSend.front();
-				messagesToSend.pop();
-				lock.unlock();
-				ws.write(boost::asio::buffer(message));
-				lock.lock();
-			}
+			auto frame = messagesReceived.Pop();
+			if (!frame) break;
+			ProcessMessage(*frame);
+			messagesReceived.Recycle(std::move(frame->bytes));
 		}
-	} catch (boost::beast::error_code& e) {
-		std::cerr << "Write error: " << e.message() << std::endl << std::flush;
 	} catch (std::exception& e) {
-		std::cerr << "Write exception: " << e.what() << std::endl << std::flush;
-		Stop();
+		std::cerr << "Processing exception: " << e.what() << std::endl << std::flush;
 	}
 }
 
-void WebSocketClient::ProcessMessage(const std::string &message) {
+void WebSocketClient::ProcessMessage(const ReceivedFrame& frame) {
+    const std::string& message = frame.bytes;
     try {
-        // Parse JSON message
-        auto jsonMessage = nlohmann::json::parse(message);
-
-        // Deserialize Packet
-        Packet packet;
-        packet.packetType = static_cast<PacketType>(jsonMessage.at("type").get<uint64_t>());
-        if (jsonMessage.contains("payload")) packet.payload = jsonMessage.at("payload");
+        // Payload-less packets are fully described by the pre-classified type,
+        // payloads are decoded by the handlers straight from the frame bytes
+        PacketType packetType = frame.type ? *frame.type : parser.ParseType(message);
 
         // Process based on PacketType
-        switch (packet.packetType) {
+        switch (packetType) {
             case PacketType::Ping:
-                RespondToPing();
+                // Only reached when the reader could not classify the frame
+                RespondToPing(OutboundLane::Housekeeping);
                 break;
             case PacketType::Pong:
                 break;
@@ -209,13 +361,15 @@ void WebSocketClient::ProcessMessage(const std::string &message) {
                 std::cout << "GameStarted!" << std::endl << std::flush;
                 break;
             case PacketType::GameState:
-                handler.HandleGameState(packet.payload);
+                handler.HandleGameState(message);
                 break;
             case PacketType::LobbyData:
-                handler.HandleLobbyData(packet.payload);
+                handler.HandleLobbyData(message);
+                messagesReceived.ReserveFrames(EstimateGameStateFrameSize(bot.lobbyData.gridDimension)
+                                               + PacketParser::FRAME_PADDING);
                 break;
             case PacketType::GameEnded:
-                handler.HandleGameEnded(packet.payload);
+                handler.HandleGameEnded(message);
                 Stop();
                 break;
             case PacketType::GameStarting:
@@ -225,8 +379,8 @@ void WebSocketClient::ProcessMessage(const std::string &message) {
                 SendLobbyRequest();
                 break;
             case PacketType::ConnectionRejected:
-                std::cerr << "Connection Rejected: " << packet.payload["reason"].get<std::string>() << std::endl
-                          << std::flush;
+                std::cerr << "Connection Rejected: " << parser.ParsePayloadString(message, "reason").value_or("")
+                          << std::endl << std::flush;
                 Stop();
                 break;
             case PacketType::InvalidPacketTypeError:
@@ -240,11 +394,7 @@ void WebSocketClient::ProcessMessage(const std::string &message) {
                 break;
             case PacketType::CustomWarning: {
                 // Custom warnings may have a payload (message)
-                std::optional<std::string> temp;
-                if (packet.payload.contains("message")) {
-                    temp = packet.payload["message"];
-                }
-                handler.OnWarningReceived(WarningType::CustomWarning, temp);
+                handler.OnWarningReceived(WarningType::CustomWarning, parser.ParsePayloadString(message, "message"));
                 break;
             }
             case PacketType::PlayerAlreadyMadeActionWarning:
@@ -265,37 +415,18 @@ void WebSocketClient::ProcessMessage(const std::string &message) {
     }
 }
 
-void WebSocketClient::RespondToPing()
+void WebSocketClient::RespondToPing(OutboundLane lane)
 {
-	try {
-		// Serialize Packet to JSON
-		nlohmann::json jsonResponse;
-		jsonResponse["type"] = static_cast<uint64_t>(PacketType::Pong);
-
-		std::string responseString = jsonResponse.dump();
-
-		// Send the response over the WebSocket
-		std::lock_guard<std::mutex> lock(mtx);
-		messagesToSend.push(responseString);
-		cv.notify_one();
-	} catch (const std::exception& e) {
-		std::cerr << "Error responding to Ping: " << e.what() << std::endl << std::flush;
-	}
+	// The reader may be the strand that drains the lanes, so it must not park on a full one.
+	// A full lane means the writer is behind anyway, the next Ping gets its Pong instead.
+	sender.TrySend(OutboundPacket(PONG_PACKET), lane);
 }
 
 void WebSocketClient::SendLobbyRequest()
 {
     try {
-        // Serialize Packet to JSON
-        nlohmann::json jsonResponse;
-        jsonResponse["type"] = static_cast<uint64_t>(PacketType::LobbyDataRequest);
-
-        std::string responseString = jsonResponse.dump();
-
         // Send the response over the WebSocket
-        std::lock_guard<std::mutex> lock(mtx);
-        messagesToSend.push(responseString);
-        cv.notify_one();
+        sender.Send(OutboundPacket(LOBBY_DATA_REQUEST_PACKET), OutboundLane::Housekeeping);
     } catch (const std::exception& e) {
         std::cerr << "Error sending lobby data request: " << e.what() << std::endl << std::flush;
     }
@@ -2,6 +2,7 @@
 
 #include "pch.h"
 #include "handler.h"
+#include "processing-queue.h"
 #include "bot/bot.h"
 
 class WebSocketClient {
@@ -17,12 +18,30 @@ class WebSocketClient {
 
  private:
 	void DoConnect();
+	/// Reader side: answers Ping in place, forwards everything else to the processing thread.
+	/// Leaves frame as an empty buffer ready for the next read.
+	void DispatchFrame(std::string& frame);
+	void ProcessingLoop();
+	void ProcessMessage(const ReceivedFrame& frame);
+	/// The Pong lane belongs to the reader, the processing thread has to pass its own lane.
+	/// Never blocks, the Pong is dropped if the lane is full.
+	void RespondToPing(OutboundLane lane = OutboundLane::Pong);
+    void SendLobbyRequest();
+
+#ifdef ASYNC_TRANSPORT
+	void OnResolve(boost::beast::error_code ec, boost::asio::ip::tcp::resolver::results_type results);
+	void OnConnect(boost::beast::error_code ec);
+	void OnHandshake(boost::beast::error_code ec);
+	void DoAsyncRead();
+	void OnRead(boost::beast::error_code ec, std::size_t bytesTransferred);
+	void ScheduleWrite();
+	void DoAsyncWrite();
+	void OnWrite(boost::beast::error_code ec, std::size_t bytesTransferred);
+	static void DoClose();
+#else
 	void DoRead();
-	void SendToProcessing();
 	void DoWrite();
-	void ProcessMessage(const std::string& message);
-	void RespondToPing();
-    void SendLobbyRequest();
+#endif
 
 	std::string host;
 	std::string port;
@@ -33,14 +52,31 @@ class WebSocketClient {
 	static boost::asio::ip::tcp::socket socket;
 	static boost::beast::websocket::stream<boost::asio::ip::tcp::socket> ws;
 	static std::thread workThread;
+
+	ProcessingQueue messagesReceived;
+	/// Prioritized lanes towards the writer
+	OutboundScheduler messagesToSend;
+	/// Shared with handler, so only the processing thread sends
+	MessageSender sender;
+
+	/// Only used from the processing thread
+	PacketParser parser;
 	Handler handler;
 	Bot bot;
 	std::promise<bool> connectPromise;
 
-	std::queue<std::string> messagesToSend;
-	std::mutex mtx;
-	std::condition_variable cv;
-	std::queue<std::string> messagesReceived;
-	std::mutex mtxR;
-	std::condition_variable cvR;
+#ifdef ASYNC_TRANSPORT
+	/// Serializes every operation on ws; the fields below are only touched from it
+	static boost::asio::strand<boost::asio::io_context::executor_type> strand;
+	static bool writing;
+	static bool closing;
+	/// Set while a drain of messagesToSend is posted to or running on the strand
+	std::atomic<bool> writeScheduled{false};
+	OutboundPacket currentWrite;
+	boost::asio::ip::tcp::resolver resolver;
+	/// Frame currently being received, handed to the processing queue by move
+	std::string readFrame;
+	/// Dynamic buffer view over readFrame, re-created for every read since it caches the size
+	std::optional<boost::asio::dynamic_string_buffer<char, std::char_traits<char>, std::allocator<char>>> readBuffer;
+#endif
 };